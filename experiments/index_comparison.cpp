@@ -1,8 +1,11 @@
 #include <iostream>
+#include <numeric>
+#include <optional>
 #include <random>
 
 #include "argparse/argparse.hpp"
 
+#include "rmi/cost_model.hpp"
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
 #include "rmi/util/fn.hpp"
@@ -82,11 +85,13 @@ std::size_t s_glob; ///< global size_t variable
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param cost the calibrated cost model of this machine used to pick the configuration, if any
  */
 void benchmark_rmi(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::optional<rmi::CostModel> &cost)
 {
     // Set hyperparameters.
     using layer1_type = rmi::LinearSpline;
@@ -102,20 +107,39 @@ void benchmark_rmi(const std::vector<key_type> &keys,
         // Build RMI.
         rmi::Rmi<key_type, layer1_type, layer2_type> test_rmi(keys, n_models);
 
-        // Evaluate RMI error.
-        auto n_keys = keys.size();
-        std::vector<double> log2_errors;
-        log2_errors.reserve(n_keys);
+        auto n_models_labs =
+            (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double) + sizeof(std::size_t));
+
+        bool use_labs;
+        if (cost) {
+            // Compare predicted lookup times of both candidates.
+            rmi::RmiLAbs<key_type, layer1_type, layer2_type> test_rmi_labs(keys, n_models_labs);
+            auto keys_bytes = keys.size() * sizeof(key_type);
+            auto pred_nb = rmi::predict_lookup_ns<layer1_type, layer2_type>(
+                *cost, rmi::error_histogram(test_rmi, keys.begin(), keys.end()), "none", "model_biased_exponential",
+                test_rmi.size_in_bytes(), keys_bytes);
+            auto pred_labs = rmi::predict_lookup_ns<layer1_type, layer2_type>(
+                *cost, rmi::error_histogram(test_rmi_labs, keys.begin(), keys.end()), "labs", "binary",
+                test_rmi_labs.size_in_bytes(), keys_bytes);
+            use_labs = pred_labs < pred_nb;
+        } else {
+            // Evaluate RMI error.
+            auto n_keys = keys.size();
+            std::vector<double> log2_errors;
+            log2_errors.reserve(n_keys);
+
+            for (std::size_t i = 0; i != n_keys; ++i) {
+                auto key = keys.at(i);
+                auto pred = test_rmi.search(key).pos;
+                auto err = pred > i ? pred - i : i - pred;
+                log2_errors.push_back(std::log2(err+1));
+            }
 
-        for (std::size_t i = 0; i != n_keys; ++i) {
-            auto key = keys.at(i);
-            auto pred = test_rmi.search(key).pos;
-            auto err = pred > i ? pred - i : i - pred;
-            log2_errors.push_back(std::log2(err+1));
+            auto mean_log2e = mean(log2_errors);
+            auto threshold = 5.8; // This is hardware-dependent.
+            use_labs = mean_log2e >= threshold;
         }
 
-        auto mean_log2e = mean(log2_errors);
-
 #define RUN(RMI_TYPE, SEARCH_FN, N_MODELS) \
         { \
             auto search_fn = SEARCH_FN(); \
@@ -172,16 +196,53 @@ void benchmark_rmi(const std::vector<key_type> &keys,
                           /* Checksums */ \
                           << eval_accu << ',' \
                           << lookup_accu << std::endl; \
+                \
+                /* Eval time of batched lookups with vectorized model evaluation. */ \
+                std::vector<rmi::Approx> ranges(samples.size()); \
+                start = steady_clock::now(); \
+                rmi.search_batch(samples.data(), samples.size(), ranges.data()); \
+                stop = steady_clock::now(); \
+                eval_time = duration_cast<nanoseconds>(stop - start).count(); \
+                eval_accu = 0; \
+                for (auto &range : ranges) eval_accu += range.pos + range.lo + range.hi; \
+                s_glob = eval_accu; \
+                \
+                /* Lookup time of batched lookups with vectorized model evaluation. */ \
+                std::vector<std::size_t> positions(samples.size()); \
+                start = steady_clock::now(); \
+                rmi.lower_bound_batch(samples.data(), samples.size(), keys.begin(), search_fn, positions.data()); \
+                stop = steady_clock::now(); \
+                lookup_time = duration_cast<nanoseconds>(stop - start).count(); \
+                lookup_accu = std::accumulate(positions.begin(), positions.end(), std::size_t(0)); \
+                s_glob = lookup_accu; \
+                \
+                /* Report results. */ \
+                          /* Dataset */ \
+                std::cout << dataset_name << ',' \
+                          << keys.size() << ',' \
+                          /* Index */ \
+                          << "RMI-ours-simd" << ',' \
+                          << "\"" << #RMI_TYPE << ',' << "layer2_size=" << N_MODELS << ",simd_width=" << RMI_SIMD_WIDTH \
+                          << "\"" << ',' \
+                          << rmi.size_in_bytes() << ',' \
+                          /* Experiment */ \
+                          << rep << ',' \
+                          << samples.size() << ',' \
+                          /* Results */ \
+                          << build_time << ',' \
+                          << eval_time << ',' \
+                          << lookup_time << ',' \
+                          /* Checksums */ \
+                          << eval_accu << ',' \
+                          << lookup_accu << std::endl; \
             } /* reps */ \
         }
 
         // Perform experiment with configuration according to guideline.
-        auto threshold = 5.8; // This is hardware-dependent.
-        if (mean_log2e < threshold) {
+        if (not use_labs) {
             RUN(rmi::Rmi, ModelBiasedExponentialSearch, n_models)
         } else {
-            n_models = (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double) + sizeof(std::size_t));
-            RUN(rmi::RmiLAbs, BinarySearch, n_models)
+            RUN(rmi::RmiLAbs, BinarySearch, n_models_labs)
         }
 
 #undef RUN
@@ -976,6 +1037,10 @@ int main(int argc, char *argv[])
         .default_value(false)
         .implicit_value(true);
 
+    program.add_argument("--profile")
+        .help("machine profile written by rmi_calibrate used to configure the RMI, guideline threshold if not set")
+        .default_value(std::string(""));
+
     program.add_argument("--rmi")
         .help("run benchmark on Recursive Model Index")
         .default_value(false)
@@ -1035,6 +1100,11 @@ int main(int argc, char *argv[])
     const auto dataset_name = split(filename, '/').back();
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto profile = program.get<std::string>("--profile");
+
+    // Load machine profile.
+    std::optional<rmi::CostModel> cost;
+    if (not profile.empty()) cost = rmi::CostModel::load(profile);
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
@@ -1065,7 +1135,7 @@ int main(int argc, char *argv[])
                   << std::endl;
 
     // Run benchmarks.
-    if (program["--rmi"]  == true) benchmark_rmi(keys, samples, n_reps, dataset_name);
+    if (program["--rmi"]  == true) benchmark_rmi(keys, samples, n_reps, dataset_name, cost);
     if (program["--alex"] == true) benchmark_alex(keys, samples, n_reps, dataset_name);
     if (program["--pgm"]  == true) benchmark_pgm(keys, samples, n_reps, dataset_name);
     if (program["--rs"]   == true) benchmark_rs(keys, samples, n_reps, dataset_name);
@@ -1,18 +1,90 @@
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "argparse/argparse.hpp"
+#include "rmi/builder.hpp"
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
+#include "rmi/util/dataset.hpp"
 
 using key_type = uint64_t;
+using keys_type = rmi::KeySpan<key_type>;
 using namespace std::chrono;
 
 std::size_t s_glob; ///< global size_t variable
 
 
 /**
- * Measures the build time for a given @p Rmi on dataset @p keys and writes results to `std::cout`.
+ * Writes the pages of file @p filename to disk and evicts them from the page cache so that the next read of the file
+ * is served from disk.
+ * @param filename name of the file
+ */
+void evict_from_page_cache(const std::string &filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+
+/**
+ * Computes the mean log2 error of the position estimates of @p rmi for all @p keys, where keys occurring more than once
+ * are expected at their first occurrence.
+ * @tparam Rmi RMI type
+ * @param rmi the RMI built on @p keys
+ * @param keys on which the RMI is built
+ * @return mean log2 error
+ */
+template<typename Rmi>
+double mean_log2_error(const Rmi &rmi, const keys_type &keys)
+{
+    double sum = 0.;
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        if (i == 0 or keys[i] != keys[i - 1]) pos = i; // first occurrence
+        auto pred = rmi.search(keys[i]).pos;
+        auto err = pred > pos ? pred - pos : pos - pred;
+        sum += std::log2(err + 1);
+    }
+    return sum / keys.size();
+}
+
+
+/**
+ * Builds @p Rmi on @p keys by pushing them in chunks to an rmi::RmiBuilder as if they were streamed, e.g., from an
+ * external merge. Layer1 is trained on every k-th key and the last key, where k is the stride of @p sampling.
+ * @tparam Rmi RMI type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param sampling the sampling of the keys layer1 is trained on
+ * @return the RMI built on @p keys
+ */
+template<typename Rmi>
+Rmi build_streaming(const keys_type &keys, const std::size_t n_models, const rmi::Sampling sampling)
+{
+    const std::size_t chunk_size = 1UL << 16;
+    const std::size_t stride = sampling.stride();
+    std::vector<key_type> sample;
+    for (std::size_t i = 0; i < keys.size(); i += stride) sample.push_back(keys[i]);
+    if ((keys.size() - 1) % stride != 0) sample.push_back(keys.back());
+
+    rmi::RmiBuilder<Rmi> builder(sample, keys.size(), n_models);
+    for (std::size_t i = 0; i < keys.size(); i += chunk_size)
+        builder.push_batch(keys.data() + i, std::min(chunk_size, keys.size() - i));
+    return builder.finish();
+}
+
+
+/**
+ * Measures the build time for a given @p Rmi on dataset @p keys and writes results to `std::cout`. The mean log2 error
+ * of the first repetition is reported for all repetitions.
  * @tparam Key key type
  * @tparam Rmi RMI type
  * @param keys on which the RMI is built
@@ -21,39 +93,66 @@ std::size_t s_glob; ///< global size_t variable
  * @param layer1 model type of the first layer
  * @param layer2 model type of the second layer
  * @param bounds_type used by the RMI
+ * @param n_threads number of threads used for building the RMI
+ * @param sample_rate fraction of the keys the models are trained on
+ * @param stream whether the RMI is built by streaming the keys to an rmi::RmiBuilder
+ * @param index_file name of the file the RMI is saved to for measuring load times
+ * @param data_load_time time to load the keys in nanoseconds
  */
 template<typename Key, typename Rmi>
-void experiment(const std::vector<key_type> &keys,
+void experiment(const keys_type &keys,
                 const std::size_t n_models,
                 const std::size_t n_reps,
                 const std::string dataset_name,
                 const std::string layer1,
                 const std::string layer2,
-                const std::string bound_type)
+                const std::string bound_type,
+                const std::size_t n_threads,
+                const double sample_rate,
+                const bool stream,
+                const std::string index_file,
+                const long data_load_time)
 {
     using rmi_type = Rmi;
+    double mean_log2e = 0.;
 
     // Perform n_reps runs.
     for (std::size_t rep = 0; rep != n_reps; ++rep) {
 
         // Build RMI.
         auto start = steady_clock::now();
-        rmi_type rmi(keys, n_models);
+        auto rmi = stream ? build_streaming<rmi_type>(keys, n_models, rmi::Sampling{sample_rate})
+                          : rmi_type(keys.begin(), keys.end(), n_models, rmi::Sampling{sample_rate}, n_threads);
         auto stop = steady_clock::now();
         auto build_time = duration_cast<nanoseconds>(stop - start).count();
 
         // Perform lookup to ensure that RMI is actually built.
-        auto key = keys.at(0);
+        auto key = keys[0];
         auto range = rmi.search(key);
         auto pos = std::lower_bound(keys.begin() + range.lo, keys.begin() + range.hi, key);
         s_glob = std::distance(keys.begin(), pos);
 
+        // Evaluate RMI error.
+        if (rep == 0) mean_log2e = mean_log2_error(rmi, keys);
+
+        // Save RMI and measure time from loading the cold file to the first lookup.
+        rmi.save(index_file);
+        evict_from_page_cache(index_file);
+        start = steady_clock::now();
+        auto loaded = rmi_type::load(index_file);
+        range = loaded.search(key);
+        stop = steady_clock::now();
+        auto load_time = duration_cast<nanoseconds>(stop - start).count();
+        pos = std::lower_bound(keys.begin() + range.lo, keys.begin() + range.hi, key);
+        s_glob += std::distance(keys.begin(), pos);
+        std::remove(index_file.c_str());
+
         // Report results.
                   // Dataset
         std::cout << dataset_name << ','
                   << keys.size() << ','
                   // Index
-                  << "ours" << ','
+                  << (stream ? "ours_stream" : "ours") << ','
                   << layer1 << ','
                   << layer2 << ','
                   << n_models << ','
@@ -61,8 +160,13 @@ void experiment(const std::vector<key_type> &keys,
                   << rmi.size_in_bytes() << ','
                   // Experiment
                   << rep << ','
+                  << n_threads << ','
+                  << sample_rate << ','
                   // Results
                   << build_time << ','
+                  << load_time << ','
+                  << data_load_time << ','
+                  << mean_log2e << ','
                   // Checksums
                   << s_glob << std::endl;
     } // reps
@@ -72,13 +176,18 @@ void experiment(const std::vector<key_type> &keys,
 /**
  * @brief experiment function pointer
  */
-typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+typedef void (*exp_fn_ptr)(const keys_type&,
                            const std::size_t,
                            const std::size_t,
                            const std::string,
                            const std::string,
                            const std::string,
-                           const std::string);
+                           const std::string,
+                           const std::size_t,
+                           const double,
+                           const bool,
+                           const std::string,
+                           const long);
 
 /**
  * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and the error bound
@@ -153,6 +262,29 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(3))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-t", "--n_threads")
+        .help("number of threads used for building the RMI")
+        .default_value(std::size_t(1))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-r", "--sample_rate")
+        .help("fraction of the keys the models are trained on")
+        .default_value(double(1.))
+        .action([](const std::string &s) { return std::stod(s); });
+
+    program.add_argument("--stream")
+        .help("build the RMI by streaming the keys in chunks, layer1 is trained on the sample given by --sample_rate")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-f", "--index_file")
+        .help("file the RMI is saved to and loaded from for measuring load times")
+        .default_value(std::string("/tmp/rmi_build.idx"));
+
+    program.add_argument("-l", "--loader")
+        .help("dataset loader, either read (ifstream), mmap, or pread (parallel reads into huge pages)")
+        .default_value(std::string("pread"));
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -175,9 +307,18 @@ int main(int argc, char *argv[])
     const auto n_models = program.get<std::size_t>("n_models");
     const auto bound_type = program.get<std::string>("bound_type");
     const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_threads = program.get<std::size_t>("-t");
+    const auto sample_rate = program.get<double>("-r");
+    const bool stream = program["--stream"] == true;
+    const auto index_file = program.get<std::string>("-f");
+    const auto loader = program.get<std::string>("-l");
 
     // Load keys.
-    auto keys = load_data<key_type>(filename);
+    auto start = steady_clock::now();
+    auto dataset = rmi::Dataset<key_type>::load(filename, loader);
+    auto stop = steady_clock::now();
+    auto data_load_time = duration_cast<nanoseconds>(stop - start).count();
+    auto keys = dataset.keys();
 
     // Lookup experiment.
     Config config{layer1, layer2, bound_type};
@@ -198,12 +339,18 @@ int main(int argc, char *argv[])
                   << "bounds,"
                   << "size_in_bytes,"
                   << "rep,"
+                  << "n_threads,"
+                  << "sample_rate,"
                   << "build_time,"
+                  << "load_time,"
+                  << "data_load_time,"
+                  << "mean_log2_error,"
                   << "checksum"
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, n_reps, dataset_name, layer1, layer2, bound_type);
+    (*exp_fn)(keys, n_models, n_reps, dataset_name, layer1, layer2, bound_type, n_threads, sample_rate, stream,
+              index_file, data_load_time);
 
     exit(EXIT_SUCCESS);
 }
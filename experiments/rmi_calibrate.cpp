@@ -0,0 +1,283 @@
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <unistd.h>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/cost_model.hpp"
+#include "rmi/models.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Measures the latency of random accesses into an array of @p n elements by chasing pointers along a random cycle
+ * through all elements, so that no access can start before the previous one finished.
+ * @param n number of elements
+ * @param n_accesses number of measured accesses
+ * @param n_reps number of repetitions
+ * @return median latency per access in nanoseconds
+ */
+double measure_latency(const std::size_t n, const std::size_t n_accesses, const std::size_t n_reps)
+{
+    // Create a random cyclic permutation using Sattolo's algorithm.
+    std::vector<std::size_t> next(n);
+    std::iota(next.begin(), next.end(), 0);
+    std::mt19937_64 gen(42);
+    for (std::size_t i = n - 1; i > 0; --i) {
+        std::uniform_int_distribution<std::size_t> distrib(0, i - 1);
+        std::swap(next[i], next[distrib(gen)]);
+    }
+
+    // Warm up caches by following the whole cycle once.
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i != n; ++i) pos = next[pos];
+
+    std::vector<double> times;
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != n_accesses; ++i) pos = next[pos];
+        auto stop = steady_clock::now();
+        s_glob = pos;
+        times.push_back(static_cast<double>(duration_cast<nanoseconds>(stop - start).count()) / n_accesses);
+    }
+    return median(times);
+}
+
+
+/**
+ * Measures the time to evaluate a model of type @p Model trained on @p keys for each of the @p samples.
+ * @tparam Model the model type
+ * @param keys on which the model is trained
+ * @param samples for which the model is evaluated
+ * @param n_reps number of repetitions
+ * @return median evaluation time per sample in nanoseconds
+ */
+template<typename Model>
+double measure_eval(const std::vector<key_type> &keys, const std::vector<key_type> &samples, const std::size_t n_reps)
+{
+    Model model(keys.begin(), keys.end());
+
+    std::vector<double> times;
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+        std::size_t eval_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i)
+            eval_accu += clamp_prediction(model.predict(samples[i]), keys.size() - 1);
+        auto stop = steady_clock::now();
+        s_glob = eval_accu;
+        times.push_back(static_cast<double>(duration_cast<nanoseconds>(stop - start).count()) / samples.size());
+    }
+    return median(times);
+}
+
+
+/**
+ * Measures the time of @p Search on @p keys per bucket of the search size as defined by rmi::CostModel, i.e., the
+ * window size for binary search, the size of the searched side for model-biased binary search, and the prediction
+ * error otherwise. For each bucket, @p n_lookups lookups of random keys are performed, whose windows and position
+ * estimates are placed around the keys such that their size equals the value representing the bucket. Lookups of
+ * model-biased linear search are reduced for large buckets.
+ * @tparam Search the search type
+ * @param keys sorted keys to search
+ * @param search the name of the search algorithm
+ * @param n_lookups number of lookups per bucket
+ * @param n_reps number of repetitions
+ * @param max_bucket the largest bucket to measure
+ * @return median search time per lookup in nanoseconds for each bucket
+ */
+template<typename Search>
+std::vector<double> measure_search(const std::vector<key_type> &keys, const std::string &search,
+                                   const std::size_t n_lookups, const std::size_t n_reps, const std::size_t max_bucket)
+{
+    auto search_fn = Search();
+    const long n = keys.size();
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<long> pos_distrib(0, n - 1);
+    std::uniform_real_distribution<double> offset_distrib(0., 1.);
+
+    std::vector<double> times;
+    std::vector<long> los, preds, his;
+    std::vector<key_type> samples;
+    for (std::size_t b = 0; b <= max_bucket; ++b) {
+        const long v = std::lround(rmi::ErrorHistogram::value(b));
+        std::size_t m = n_lookups;
+        if (search == "model_biased_linear") m = std::max<std::size_t>(n_lookups / std::max(1l, v / 64), 100);
+
+        // Place windows and position estimates around random keys.
+        los.clear();
+        preds.clear();
+        his.clear();
+        samples.clear();
+        for (std::size_t i = 0; i != m; ++i) {
+            long pos = pos_distrib(gen);
+            double offset = offset_distrib(gen);
+            long lo, pred, hi;
+            if (search == "binary") { // window of size v containing the key
+                lo = pos - static_cast<long>(offset * std::max(v, 1l));
+                hi = lo + std::max(v, 1l);
+                pred = pos;
+            } else if (search == "model_biased_binary") { // sides of size v around the estimate
+                pred = pos - v + static_cast<long>(offset * (2 * v + 1));
+                lo = pred - v;
+                hi = pred + v + 1;
+            } else { // estimate at distance v, no window
+                pred = offset < 0.5 ? pos - v : pos + v;
+                lo = 0;
+                hi = n;
+            }
+            lo = std::max(lo, 0l);
+            hi = std::min(hi, n);
+            los.push_back(lo);
+            preds.push_back(std::clamp(pred, lo, hi - 1));
+            his.push_back(hi);
+            samples.push_back(keys[pos]);
+        }
+
+        std::vector<double> rep_times;
+        for (std::size_t rep = 0; rep != n_reps; ++rep) {
+            std::size_t lookup_accu = 0;
+            auto start = steady_clock::now();
+            for (std::size_t i = 0; i != m; ++i) {
+                auto pos = search_fn(keys.begin() + los[i], keys.begin() + his[i], keys.begin() + preds[i], samples[i]);
+                lookup_accu += std::distance(keys.begin(), pos);
+            }
+            auto stop = steady_clock::now();
+            s_glob = lookup_accu;
+            rep_times.push_back(static_cast<double>(duration_cast<nanoseconds>(stop - start).count()) / m);
+        }
+        times.push_back(median(rep_times));
+    }
+    return times;
+}
+
+
+/**
+ * Measures the search tables of all searches of rmi::CostModel on @p keys and stores them in @p tables.
+ * @param keys sorted keys to search
+ * @param n_lookups number of lookups per bucket
+ * @param n_reps number of repetitions
+ * @param tables the search tables of the cost model
+ */
+void measure_searches(const std::vector<key_type> &keys, const std::size_t n_lookups, const std::size_t n_reps,
+                      std::map<std::string, std::vector<double>> &tables)
+{
+    const std::size_t max_bucket = rmi::ErrorHistogram::bucket(keys.size() - 1);
+    const std::size_t max_linear_bucket = std::min<std::size_t>(max_bucket, 16); // larger errors are extrapolated
+    tables["binary"] = measure_search<BinarySearch>(keys, "binary", n_lookups, n_reps, max_bucket);
+    tables["model_biased_binary"] =
+        measure_search<ModelBiasedBinarySearch>(keys, "model_biased_binary", n_lookups, n_reps, max_bucket - 1);
+    tables["model_biased_exponential"] = measure_search<ModelBiasedExponentialSearch>(
+        keys, "model_biased_exponential", n_lookups, n_reps, max_bucket - 1);
+    tables["model_biased_linear"] =
+        measure_search<ModelBiasedLinearSearch>(keys, "model_biased_linear", n_lookups, n_reps, max_linear_bucket);
+}
+
+
+/**
+ * Creates @p n sorted random keys.
+ * @param n number of keys
+ * @return vector of sorted keys
+ */
+std::vector<key_type> random_keys(const std::size_t n)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<key_type> distrib;
+    std::vector<key_type> keys(n);
+    std::generate(keys.begin(), keys.end(), [&] { return distrib(gen); });
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+
+/**
+ * Calibrates the RMI cost model on this machine by microbenchmarking cache and DRAM latency, model evaluation, and
+ * searches, and writes the resulting machine profile.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("-o", "--output")
+        .help("file to write the machine profile to")
+        .default_value(std::string("machine_profile.csv"));
+
+    program.add_argument("-k", "--n_keys")
+        .help("number of keys searched in DRAM, should exceed the last-level cache by far")
+        .default_value(std::size_t(1UL << 25))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of lookups per measurement")
+        .default_value(std::size_t(100'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of repetitions of each measurement, the median is reported")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--llc_bytes")
+        .help("size of the last-level cache in bytes, detected if not set")
+        .default_value(std::size_t(0))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("-o");
+    const auto n_keys = program.get<std::size_t>("-k");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto n_reps = program.get<std::size_t>("-n");
+    auto llc_bytes = program.get<std::size_t>("--llc_bytes");
+
+    rmi::CostModel cost;
+    if (llc_bytes == 0) {
+        long detected = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        llc_bytes = detected > 0 ? detected : cost.llc_bytes;
+    }
+    cost.llc_bytes = llc_bytes;
+    const std::size_t n_cached_keys = llc_bytes / 4 / sizeof(key_type); // leaves room for the index
+
+    // Measure access latencies.
+    cost.dram_ns = measure_latency(n_keys, n_samples, n_reps);
+    cost.cache_ns = measure_latency(n_cached_keys, n_samples, n_reps);
+
+    // Measure model evaluation.
+    auto keys = random_keys(n_keys);
+    std::vector<key_type> samples;
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<std::size_t> distrib(0, n_keys - 1);
+    for (std::size_t i = 0; i != n_samples; ++i) samples.push_back(keys[distrib(gen)]);
+    cost.linear_eval_ns = (measure_eval<rmi::LinearSpline>(keys, samples, n_reps) +
+                           measure_eval<rmi::LinearRegression>(keys, samples, n_reps)) / 2;
+    cost.cubic_eval_ns = measure_eval<rmi::CubicSpline>(keys, samples, n_reps);
+    cost.radix_eval_ns = measure_eval<rmi::Radix<key_type>>(keys, samples, n_reps);
+
+    // Measure searches on keys in DRAM and on cached keys.
+    measure_searches(keys, n_samples, n_reps, cost.search_dram_ns);
+    keys = random_keys(n_cached_keys);
+    measure_searches(keys, n_samples, n_reps, cost.search_cached_ns);
+
+    // Write machine profile.
+    cost.save(filename);
+
+    exit(EXIT_SUCCESS);
+}
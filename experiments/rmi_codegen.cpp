@@ -0,0 +1,151 @@
+#include <chrono>
+#include <map>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/codegen.hpp"
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+
+/**
+ * Builds an RMI of type @p Rmi on @p keys and generates a header/source pair of a specialized index from it.
+ * @tparam Rmi RMI type
+ * @param keys on which the RMI is built
+ * @param layer2_size the number of models in layer2
+ * @param name the namespace of the generated index
+ * @param directory the directory to write the files to
+ */
+template<typename Rmi>
+void generate(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::string &name,
+              const std::string &directory)
+{
+    auto start = steady_clock::now();
+    Rmi rmi(keys, layer2_size);
+    auto stop = steady_clock::now();
+    auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+    rmi::generate(rmi, name, directory, build_time);
+}
+
+
+/*======================================================================================================================
+ * Configurations
+ *====================================================================================================================*/
+
+using gen_fn_ptr = void(*)(const std::vector<key_type>&, const std::size_t, const std::string&, const std::string&);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and error bound type.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        return lhs.bound_type < rhs.bound_type;
+    }
+};
+
+#define ENTRIES(L1, L2, LT1, LT2) \
+    { {#L1, #L2, "none"}, &generate<rmi::Rmi<key_type, LT1, LT2>> }, \
+    { {#L1, #L2, "labs"}, &generate<rmi::RmiLAbs<key_type, LT1, LT2>> }, \
+    { {#L1, #L2, "lind"}, &generate<rmi::RmiLInd<key_type, LT1, LT2>> }, \
+    { {#L1, #L2, "gabs"}, &generate<rmi::RmiGAbs<key_type, LT1, LT2>> }, \
+    { {#L1, #L2, "gind"}, &generate<rmi::RmiGInd<key_type, LT1, LT2>> }, \
+
+static std::map<Config, gen_fn_ptr, ConfigCompare> gen_map {
+    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    ENTRIES(linear_regression, cubic_spline,      rmi::LinearRegression, rmi::CubicSpline)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+}; ///< Map that assigns a generator function pointer to RMI configurations.
+
+#undef ENTRIES
+
+/**
+ * Builds an RMI configuration provided via command line arguments and generates a specialized header/source pair.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("name")
+        .help("namespace of the generated index, also used as file name.");
+
+    program.add_argument("-o", "--output")
+        .help("directory to write the generated files to")
+        .default_value(std::string("."));
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto name = program.get<std::string>("name");
+    const auto directory = program.get<std::string>("-o");
+
+    // Look up configuration.
+    Config config{layer1, layer2, bound_type};
+    if (gen_map.find(config) == gen_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type << " is not a valid RMI configuration."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    gen_fn_ptr gen_fn = gen_map[config];
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Generate code.
+    (*gen_fn)(keys, n_models, name, directory);
+
+    exit(EXIT_SUCCESS);
+}
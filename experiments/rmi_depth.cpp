@@ -0,0 +1,287 @@
+#include <array>
+#include <chrono>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi_n.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Measures build and lookup times of @p samples on a given @p Rmi with @p n_layers layers and writes results to
+ * `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @tparam Search search type
+ * @tparam NLayers number of layers of the RMI
+ * @param keys on which the RMI is built
+ * @param layer_sizes number of models in each layer of the RMI, starting with the second layer
+ * @param samples for which the lookup time is measured
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the remaining layers
+ * @param bound_type used by the RMI
+ * @param search used by the RMI for correction prediction errors
+ */
+template<typename Key, typename Rmi, typename Search, std::size_t NLayers>
+void experiment(const std::vector<key_type> &keys,
+                const std::vector<std::size_t> &layer_sizes,
+                const std::vector<key_type> &samples,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string search)
+{
+    using rmi_type = Rmi;
+    auto search_fn = Search();
+
+    if (layer_sizes.size() != NLayers - 1) {
+        std::cerr << "Error: expected " << NLayers - 1 << " layer sizes." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::array<std::size_t, NLayers - 1> sizes;
+    std::copy(layer_sizes.begin(), layer_sizes.end(), sizes.begin());
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build RMI.
+        auto start = steady_clock::now();
+        rmi_type rmi(keys, sizes);
+        auto stop = steady_clock::now();
+        auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto key = samples.at(i);
+            auto range = rmi.search(key);
+            auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
+            lookup_accu += std::distance(keys.begin(), pos);
+        }
+        stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << layer1 << ','
+                  << layer2 << ','
+                  << NLayers << ',';
+        for (std::size_t i = 0; i != sizes.size(); ++i)
+            std::cout << (i == 0 ? "" : ":") << sizes[i];
+        std::cout << ','
+                  << sizes.back() << ','
+                  << bound_type << ','
+                  << search << ','
+                  << rmi.size_in_bytes() << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  // Results
+                  << build_time << ','
+                  << lookup_time << ','
+                  // Checksums
+                  << lookup_accu << std::endl;
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::vector<std::size_t>&,
+                           const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+
+/**
+ * RMI configuration that holds the string representation of model types of the first and the remaining layers, the
+ * number of layers, error bound type, and search algorithm.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::size_t n_layers;
+    std::string bound_type;
+    std::string search;
+};
+
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        if (lhs.n_layers != rhs.n_layers) return lhs.n_layers < rhs.n_layers;
+        if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
+        return lhs.search < rhs.search;
+    }
+};
+
+
+#define LAYERS_2(LT1, LT2) key_type, LT1, LT2
+#define LAYERS_3(LT1, LT2) key_type, LT1, LT2, LT2
+#define LAYERS_4(LT1, LT2) key_type, LT1, LT2, LT2, LT2
+
+#define ENTRIES_N(L1, L2, LT1, LT2, N) \
+    { {#L1, #L2, N, "none", "model_biased_exponential"}, &experiment<key_type, rmi::RmiN<LAYERS_##N(LT1, LT2)>, ModelBiasedExponentialSearch, N> }, \
+    { {#L1, #L2, N, "labs", "binary"}, &experiment<key_type, rmi::RmiNLAbs<LAYERS_##N(LT1, LT2)>, BinarySearch, N> }, \
+    { {#L1, #L2, N, "lind", "model_biased_binary"}, &experiment<key_type, rmi::RmiNLInd<LAYERS_##N(LT1, LT2)>, ModelBiasedBinarySearch, N> }, \
+    { {#L1, #L2, N, "gabs", "binary"}, &experiment<key_type, rmi::RmiNGAbs<LAYERS_##N(LT1, LT2)>, BinarySearch, N> }, \
+    { {#L1, #L2, N, "gind", "model_biased_binary"}, &experiment<key_type, rmi::RmiNGInd<LAYERS_##N(LT1, LT2)>, ModelBiasedBinarySearch, N> },
+
+#define ENTRIES(L1, L2, LT1, LT2) \
+    ENTRIES_N(L1, L2, LT1, LT2, 2) \
+    ENTRIES_N(L1, L2, LT1, LT2, 3) \
+    ENTRIES_N(L1, L2, LT1, LT2, 4)
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+
+#undef ENTRIES
+#undef ENTRIES_N
+#undef LAYERS_2
+#undef LAYERS_3
+#undef LAYERS_4
+
+
+/**
+ * Triggers measurement of build and lookup times for an RMI configuration of arbitrary depth provided via command line
+ * arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("model type of the first layer, either linear_spline, cubic_spline, or radix.");
+
+    program.add_argument("layer2")
+        .help("model type of the remaining layers, only linear_regression is supported.");
+
+    program.add_argument("layer_sizes")
+        .help("comma-separated number of models in each layer after the first, e.g., 1024,1048576 for three layers.");
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("search")
+        .help("search algorithm for error correction, model_biased_exponential for none, binary for labs and gabs, "
+              "model_biased_binary for lind and gind.");
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto search = program.get<std::string>("search");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    std::vector<std::size_t> layer_sizes;
+    for (auto &s : split(program.get<std::string>("layer_sizes"), ','))
+        layer_sizes.push_back(std::stoul(s));
+
+    // Lookup experiment.
+    Config config{layer1, layer2, layer_sizes.size() + 1, bound_type, search};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << layer_sizes.size() + 1 << " layers," << bound_type
+                  << ',' << search << " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
+    std::vector<key_type> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        samples.push_back(keys[distrib(gen)]);
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_layers,"
+                  << "layer_sizes,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "search,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "build_time,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, layer_sizes, samples, n_reps, dataset_name, layer1, layer2, bound_type, search);
+
+    exit(EXIT_SUCCESS);
+}
@@ -1,11 +1,13 @@
 #include <chrono>
 #include <cmath>
+#include <optional>
 #include <random>
 
 #include "argparse/argparse.hpp"
 
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
+#include "rmi/tune.hpp"
 #include "rmi/util/fn.hpp"
 #include "rmi/util/search.hpp"
 
@@ -30,6 +32,8 @@ std::size_t s_glob; ///< global size_t variable
  * @param bounds used by the RMI
  * @param search used by the RMI for correction prediction errors
  * @param budget the budget under which the configuration was chosen
+ * @param is_guideline whether the configuration was chosen by the guideline
+ * @param is_tuned whether the configuration was chosen by the tuner
  */
 template<typename Key, typename Rmi, typename Search>
 void experiment(const std::vector<key_type> &keys,
@@ -42,7 +46,8 @@ void experiment(const std::vector<key_type> &keys,
                 const std::string bounds,
                 const std::string search,
                 const std::size_t budget,
-                const bool is_guideline)
+                const bool is_guideline,
+                const bool is_tuned)
 {
     using rmi_type = Rmi;
     auto search_fn = Search();
@@ -51,7 +56,7 @@ void experiment(const std::vector<key_type> &keys,
     rmi_type rmi(keys, n_models);
 
     // Skip configurations that are guaranteed to not be the fastest.
-    if (search == "model_biased_linear") {
+    if (search == "model_biased_linear" and not is_tuned) {
         auto n_keys = keys.size();
         std::vector<std::size_t> errors;
         errors.reserve(n_keys);
@@ -99,6 +104,7 @@ void experiment(const std::vector<key_type> &keys,
                   << samples.size() << ','
                   << budget << ','
                   << is_guideline << ','
+                  << is_tuned << ','
                   // Results
                   << lookup_time << ','
                   // Checksums
@@ -120,6 +126,7 @@ typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
                            const std::string,
                            const std::string,
                            const std::size_t,
+                           const bool,
                            const bool);
 
 
@@ -194,69 +201,123 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
 
 
 /*
- * Computes the recommended RMI configuration by following a simple guideline and evaluates its performance.
+ * Computes the recommended RMI configuration by following a simple guideline and evaluates its performance. The
+ * guideline picks LS->LR with no bounds and model-biased exponential search for small errors and otherwise LS->LR with
+ * local absolute bounds and binary search. Given a machine profile @p cost, both candidates are built and the one with
+ * the lower predicted lookup time is picked, otherwise a hardware-dependent threshold on the mean log2 error is used.
  * @param keys on which the RMI is built
  * @param samples for which the lookup time is measured
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
  * @param budget the budget under which the configuration is to be chosen
+ * @param cost the calibrated cost model of this machine, if any
  */
 void evaluate_guideline(const std::vector<key_type> &keys,
                         const std::vector<key_type> &samples,
                         const std::size_t n_reps,
                         const std::string dataset_name,
-                        const std::size_t budget)
+                        const std::size_t budget,
+                        const std::optional<rmi::CostModel> &cost)
 {
-    // Dermine maximum number of layer 2 models for LS->LR NB+MExp.
-    auto n_models = (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double));
+    // Dermine maximum number of layer 2 models for LS->LR NB+MExp and LS->LR LAbs+Bin.
+    auto n_models_nb = (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double));
+    auto n_models_labs =
+        (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double) + sizeof(std::size_t));
 
     // Train RMI.
-    rmi::Rmi<key_type, rmi::LinearSpline, rmi::LinearRegression> rmi(keys, n_models);
-
-    // Evaluate RMI error.
-    auto n_keys = keys.size();
-    std::vector<double> log2_errors;
-    log2_errors.reserve(n_keys);
-
-    for (std::size_t i = 0; i != n_keys; ++i) {
-        auto key = keys.at(i);
-        auto pred = rmi.search(key).pos;
-        auto err = pred > i ? pred - i : i - pred;
-        log2_errors.push_back(std::log2(err+1));
-    }
+    rmi::Rmi<key_type, rmi::LinearSpline, rmi::LinearRegression> rmi(keys, n_models_nb);
+
+    bool use_labs;
+    if (cost) {
+        // Compare predicted lookup times of both candidates.
+        using Layer1 = rmi::LinearSpline;
+        using Layer2 = rmi::LinearRegression;
+        rmi::RmiLAbs<key_type, Layer1, Layer2> rmi_labs(keys, n_models_labs);
+        auto keys_bytes = keys.size() * sizeof(key_type);
+        auto pred_nb = rmi::predict_lookup_ns<Layer1, Layer2>(
+            *cost, rmi::error_histogram(rmi, keys.begin(), keys.end()), "none", "model_biased_exponential",
+            rmi.size_in_bytes(), keys_bytes);
+        auto pred_labs = rmi::predict_lookup_ns<Layer1, Layer2>(
+            *cost, rmi::error_histogram(rmi_labs, keys.begin(), keys.end()), "labs", "binary",
+            rmi_labs.size_in_bytes(), keys_bytes);
+        use_labs = pred_labs < pred_nb;
+    } else {
+        // Evaluate RMI error.
+        auto n_keys = keys.size();
+        std::vector<double> log2_errors;
+        log2_errors.reserve(n_keys);
 
-    auto mean_log2e = mean(log2_errors);
+        for (std::size_t i = 0; i != n_keys; ++i) {
+            auto key = keys.at(i);
+            auto pred = rmi.search(key).pos;
+            auto err = pred > i ? pred - i : i - pred;
+            log2_errors.push_back(std::log2(err+1));
+        }
 
-    // Pick and evaluate guideline config based on errors.
+        auto mean_log2e = mean(log2_errors);
+
+        auto threshold = 5.8; // This is hardware-dependent.
+        use_labs = mean_log2e >= threshold;
+    }
+
+    // Pick and evaluate guideline config.
     auto l1 = "linear_spline";
     auto l2 = "linear_regression";
 
-    auto threshold = 5.8; // This is hardware-dependent.
-
-    if (mean_log2e < threshold) {
+    if (not use_labs) {
         auto bounds = "none";
         auto search = "model_biased_exponential";
 
         Config config {l1, l2, bounds, search};
         exp_fn_ptr exp_fn = exp_map[config];
 
-        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true);
+        (*exp_fn)(keys, n_models_nb, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true, false);
     } else {
         auto bounds = "labs";
         auto search = "binary";
-        n_models = (budget - 2 * sizeof(double) - 2 * sizeof(std::size_t)) / (2 * sizeof(double) + sizeof(std::size_t));
 
         Config config {l1, l2, bounds, search};
         exp_fn_ptr exp_fn = exp_map[config];
 
-        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true);
+        (*exp_fn)(keys, n_models_labs, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true, false);
     }
 }
 
 
+/*
+ * Computes the RMI configuration chosen by the tuner and evaluates its performance.
+ * @param keys on which the RMI is built
+ * @param samples for which the lookup time is measured
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param budget the budget under which the configuration is to be chosen
+ * @param n_tune_samples number of samples used by the tuner
+ * @param cost the calibrated cost model of this machine, if any
+ */
+void evaluate_tuner(const std::vector<key_type> &keys,
+                    const std::vector<key_type> &samples,
+                    const std::size_t n_reps,
+                    const std::string dataset_name,
+                    const std::size_t budget,
+                    const std::size_t n_tune_samples,
+                    const std::optional<rmi::CostModel> &cost)
+{
+    // Tune on a prefix of the (random) samples.
+    std::vector<key_type> workload(samples.begin(), samples.begin() + std::min(n_tune_samples, samples.size()));
+    auto tuned = rmi::tune(keys, budget, workload, cost.value_or(rmi::CostModel()));
+
+    // Evaluate tuned config.
+    Config config {tuned.layer1, tuned.layer2, tuned.bounds, tuned.search};
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    (*exp_fn)(keys, tuned.layer2_size, samples, n_reps, dataset_name, tuned.layer1, tuned.layer2, tuned.bounds,
+              tuned.search, budget, false, true);
+}
+
+
 /**
- * Tests RMI configurations for a given size budget and compares them against the performance chosen by the guideline in
- * termns of lookup time.
+ * Tests RMI configurations for a given size budget and compares them against the performance of the configurations
+ * chosen by the guideline and by the tuner in termns of lookup time.
  * @param argc arguments counter
  * @param argv arguments vector
  */
@@ -283,6 +344,15 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(1'000'000))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-t", "--n_tune_samples")
+        .help("number of sampled lookup keys used by the tuner")
+        .default_value(std::size_t(10'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--profile")
+        .help("machine profile written by rmi_calibrate, default cost model if not set")
+        .default_value(std::string(""));
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -303,6 +373,12 @@ int main(int argc, char *argv[])
     const auto budget = program.get<std::size_t>("budget");
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto n_tune_samples = program.get<std::size_t>("-t");
+    const auto profile = program.get<std::string>("--profile");
+
+    // Load machine profile.
+    std::optional<rmi::CostModel> cost;
+    if (not profile.empty()) cost = rmi::CostModel::load(profile);
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
@@ -353,6 +429,7 @@ int main(int argc, char *argv[])
                   << "n_samples,"
                   << "budget_in_bytes,"
                   << "is_guideline,"
+                  << "is_tuned,"
                   << "lookup_time,"
                   << "lookup_accu"
                   << std::endl;
@@ -374,13 +451,16 @@ int main(int argc, char *argv[])
                 exp_fn_ptr exp_fn = exp_map[config];
 
                 // Call evaluatin function with keys and n_models.
-                (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, false);
+                (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, false, false);
             }
         }
     }
 
     // Evaluate guideline configuration.
-    evaluate_guideline(keys, samples, n_reps, dataset_name, budget);
+    evaluate_guideline(keys, samples, n_reps, dataset_name, budget, cost);
+
+    // Evaluate tuned configuration.
+    evaluate_tuner(keys, samples, n_reps, dataset_name, budget, n_tune_samples, cost);
 
     exit(EXIT_SUCCESS);
 }
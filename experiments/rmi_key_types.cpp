@@ -0,0 +1,317 @@
+#include <chrono>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+
+using namespace std::chrono;
+
+using rmi::uint128_t;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Converts the sorted 64-bit @p keys of a dataset to sorted keys of type @p Key. 32-bit keys keep the 32 most
+ * significant bits of the key range, signed keys are shifted to be centered around zero, doubles are converted by
+ * value, and 128-bit keys are composite keys with the original key as high part and its position as low part.
+ * @tparam Key type of the converted keys
+ * @param keys sorted 64-bit keys
+ * @return sorted keys of type @p Key
+ */
+template<typename Key>
+std::vector<Key> convert_keys(const std::vector<uint64_t> &keys)
+{
+    std::vector<Key> converted;
+    converted.reserve(keys.size());
+    if constexpr (std::is_same<Key, uint32_t>::value) {
+        uint8_t width = keys.empty() or keys.back() == 0 ? 0 : bit_width<uint64_t>(keys.back());
+        uint8_t shift = width > 32 ? width - 32 : 0;
+        for (auto key : keys)
+            converted.push_back(key >> shift);
+    } else if constexpr (std::is_same<Key, int64_t>::value) {
+        for (auto key : keys)
+            converted.push_back(static_cast<int64_t>(key ^ (uint64_t(1) << 63)));
+    } else if constexpr (std::is_same<Key, uint128_t>::value) {
+        for (std::size_t i = 0; i != keys.size(); ++i)
+            converted.push_back(uint128_t(keys[i]) << 64 | i);
+    } else {
+        for (auto key : keys)
+            converted.push_back(static_cast<Key>(key));
+    }
+    return converted;
+}
+
+
+/**
+ * Converts the 64-bit keys to @p Key, then measures build and lookup times of the keys at @p positions on a given
+ * @p Rmi and writes results to `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @tparam Search search type
+ * @param raw_keys sorted 64-bit keys that are converted to @p Key
+ * @param n_models number of models in the second layer of the RMI
+ * @param positions of the keys for which the lookup time is measured
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param key_type name of the key type
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ * @param search used by the RMI for correction prediction errors
+ */
+template<typename Key, typename Rmi, typename Search>
+void experiment(const std::vector<uint64_t> &raw_keys,
+                const std::size_t n_models,
+                const std::vector<std::size_t> &positions,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string key_type,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string search)
+{
+    using rmi_type = Rmi;
+    auto search_fn = Search();
+
+    // Convert keys and samples.
+    auto keys = convert_keys<Key>(raw_keys);
+    std::vector<Key> samples;
+    samples.reserve(positions.size());
+    for (auto pos : positions)
+        samples.push_back(keys[pos]);
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build RMI.
+        auto start = steady_clock::now();
+        rmi_type rmi(keys, n_models);
+        auto stop = steady_clock::now();
+        auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto key = samples[i];
+            auto range = rmi.search(key);
+            auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
+            lookup_accu += std::distance(keys.begin(), pos);
+        }
+        stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  << key_type << ','
+                  << sizeof(Key) << ','
+                  // Index
+                  << layer1 << ','
+                  << layer2 << ','
+                  << n_models << ','
+                  << bound_type << ','
+                  << search << ','
+                  << rmi.size_in_bytes() << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  // Results
+                  << build_time << ','
+                  << lookup_time << ','
+                  // Checksums
+                  << lookup_accu << std::endl;
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<uint64_t>&,
+                           const std::size_t,
+                           const std::vector<std::size_t>&,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of the key type, model types of layer 1 and layer 2, error
+ * bound type, and search algorithm.
+ */
+struct Config {
+    std::string key_type;
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+    std::string search;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.key_type != rhs.key_type) return lhs.key_type < rhs.key_type;
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
+        return lhs.search < rhs.search;
+    }
+};
+
+template<typename Key>
+using CenteredLinearRegression = rmi::Centered<rmi::LinearRegression, Key>; ///< Linear regression on centered keys.
+
+#define BOUNDS(K, KT, L1, L2, LT1, LT2) \
+    { {#K, #L1, #L2, "none", "model_biased_exponential"}, &experiment<KT, rmi::Rmi<KT, LT1, LT2>, ModelBiasedExponentialSearch> }, \
+    { {#K, #L1, #L2, "labs", "binary"}, &experiment<KT, rmi::RmiLAbs<KT, LT1, LT2>, BinarySearch> }, \
+    { {#K, #L1, #L2, "labs", "cacheline_binary"}, &experiment<KT, rmi::RmiLAbs<KT, LT1, LT2>, CachelineBinarySearch> }, \
+    { {#K, #L1, #L2, "lind", "model_biased_binary"}, &experiment<KT, rmi::RmiLInd<KT, LT1, LT2>, ModelBiasedBinarySearch> },
+
+#define ENTRIES(K, KT) \
+    BOUNDS(K, KT, linear_spline, linear_regression,          rmi::LinearSpline, rmi::LinearRegression) \
+    BOUNDS(K, KT, linear_spline, centered_linear_regression, rmi::LinearSpline, CenteredLinearRegression<KT>) \
+    BOUNDS(K, KT, radix,         linear_regression,          rmi::Radix<KT>,    rmi::LinearRegression) \
+    BOUNDS(K, KT, radix,         centered_linear_regression, rmi::Radix<KT>,    CenteredLinearRegression<KT>)
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(uint32,  uint32_t)
+    ENTRIES(uint64,  uint64_t)
+    ENTRIES(int64,   int64_t)
+    ENTRIES(double,  double)
+    ENTRIES(uint128, uint128_t)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+
+#undef ENTRIES
+#undef BOUNDS
+
+
+/**
+ * Triggers measurement of build and lookup times for a key type and RMI configuration provided via command line
+ * arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("key_type")
+        .help("type the keys are converted to, either uint32, uint64, int64, double, or uint128.");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_spline or radix.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression or centered_linear_regression.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, or lind.");
+
+    program.add_argument("search")
+        .help("search algorithm for error correction, model_biased_exponential for none, binary or cacheline_binary "
+              "for labs, model_biased_binary for lind.");
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto key_type = program.get<std::string>("key_type");
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto search = program.get<std::string>("search");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+
+    // Lookup experiment.
+    Config config{key_type, layer1, layer2, bound_type, search};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << key_type << ',' << layer1 << ',' << layer2 << ',' << bound_type << ',' << search
+                  << " is not a valid configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Load keys.
+    auto keys = load_data<uint64_t>(filename);
+
+    // Sample positions of lookup keys.
+    uint64_t seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
+    std::vector<std::size_t> positions;
+    positions.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        positions.push_back(distrib(gen));
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "key_type,"
+                  << "key_size,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "search,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "build_time,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, positions, n_reps, dataset_name, key_type, layer1, layer2, bound_type, search);
+
+    exit(EXIT_SUCCESS);
+}
@@ -5,16 +5,78 @@
 
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
+#include "rmi/util/allocator.hpp"
+#include "rmi/util/coro.hpp"
+#include "rmi/util/dataset.hpp"
 #include "rmi/util/fn.hpp"
 #include "rmi/util/search.hpp"
 #include "rmi/util/perf_event.h"
 
 using key_type = uint64_t;
+using keys_type = rmi::KeySpan<key_type>;
 using namespace std::chrono;
 
 std::size_t s_glob; ///< global size_t variable
 
 
+/**
+ * Checks that the segment ids and, within each segment, the position estimates of @p rmi are monotonic in the @p keys
+ * and that the search bounds of each key contain its first occurrence. Exits with an error on the first violation.
+ * @tparam Rmi RMI type
+ * @param rmi the RMI to check
+ * @param keys on which the RMI is built
+ */
+template<typename Rmi>
+void check(const Rmi &rmi, const keys_type &keys)
+{
+    std::size_t prev_segment_id = 0;
+    std::size_t prev_pos = 0;
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        if (i != 0 and keys[i] == keys[i - 1]) continue; // bounds only cover first occurrences
+        auto segment_id = rmi.get_segment_id(keys[i]);
+        auto range = rmi.search(keys[i], segment_id);
+        if (segment_id < prev_segment_id or (segment_id == prev_segment_id and range.pos < prev_pos)) {
+            std::cerr << "Error: prediction of key " << keys[i] << " at position " << i << " is not monotonic."
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (i < range.lo or i >= range.hi) {
+            std::cerr << "Error: bounds [" << range.lo << ", " << range.hi << ") of key " << keys[i]
+                      << " do not contain its position " << i << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        prev_segment_id = segment_id;
+        prev_pos = range.pos;
+    }
+}
+
+
+/**
+ * Checks an RMI built on three random keys of @p keys with 1000 segments, drawn such that layer1 routes the first key
+ * to a segment other than 0, i.e., the leading segments are empty. Exits with an error on the first violation, see
+ * check(). Run under AddressSanitizer, this also catches models of empty segments reading keys out of bounds. Does
+ * nothing if layer1 maps the first key to segment 0 for every draw, e.g., for linear splines.
+ * @tparam Rmi RMI type
+ * @param keys from which the three keys are drawn
+ */
+template<typename Rmi>
+void check_leading_segments(const keys_type &keys)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> distrib(0, keys.size() - 1);
+    for (std::size_t attempt = 0; attempt != 100; ++attempt) {
+        std::vector<key_type> sample;
+        for (std::size_t i = 0; i != 3; ++i)
+            sample.push_back(keys[distrib(gen)]);
+        std::sort(sample.begin(), sample.end());
+        Rmi rmi(sample.begin(), sample.end(), 1000);
+        if (rmi.get_segment_id(sample.front()) == 0) continue; // no empty leading segments
+        check(rmi, keys_type(sample));
+        return;
+    }
+}
+
+
 /**
  * Measures lookup times of @p samples on a given @p Rmi and writes results to `std::cout`.
  * @tparam Key key type
@@ -29,9 +91,12 @@ std::size_t s_glob; ///< global size_t variable
  * @param layer2 model type of the second layer
  * @param bound_type used by the RMI
  * @param search used by the RMI for correction prediction errors
+ * @param n_inflight number of interleaved lookups in flight for coroutine-based lookups
+ * @param check_rmi whether to check the RMI and an RMI with empty leading segments before measuring
+ * @param data_load_time time to load the keys in nanoseconds
  */
 template<typename Key, typename Rmi, typename Search>
-void experiment(const std::vector<key_type> &keys,
+void experiment(const keys_type &keys,
                 const std::size_t n_models,
                 const std::vector<key_type> &samples,
                 const std::size_t n_reps,
@@ -39,14 +104,21 @@ void experiment(const std::vector<key_type> &keys,
                 const std::string layer1,
                 const std::string layer2,
                 const std::string bound_type,
-                const std::string search)
+                const std::string search,
+                const std::size_t n_inflight,
+                const bool check_rmi,
+                const long data_load_time)
 {
 
     using rmi_type = Rmi;
     auto search_fn = Search();
 
     // Build RMI.
-    rmi_type rmi(keys, n_models);
+    rmi_type rmi(keys.begin(), keys.end(), n_models);
+    if (check_rmi) {
+        check(rmi, keys);
+        check_leading_segments<rmi_type>(keys);
+    }
 
     // Perform n_reps runs.
     for (std::size_t rep = 0; rep != n_reps; ++rep)
@@ -69,7 +141,7 @@ void experiment(const std::vector<key_type> &keys,
             auto predict_start = steady_clock::now();
             auto range = rmi.search(key);
             auto predict_end = steady_clock::now();
-            predict_time += duration_cast<nanoseconds>(predict_start - predict_end).count();
+            predict_time += duration_cast<nanoseconds>(predict_end - predict_start).count();
 
             // searchbound= (keys.begin() + range.hi) - (keys.begin() + range.lo);
 
@@ -77,7 +149,7 @@ void experiment(const std::vector<key_type> &keys,
             auto search_start = steady_clock::now();
             auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
             auto search_end = steady_clock::now();
-            search_time += duration_cast<nanoseconds>(search_start - search_end).count();
+            search_time += duration_cast<nanoseconds>(search_end - search_start).count();
             //                disable_perf_event(corr_fd);
 
             lookup_accu += std::distance(keys.begin(), pos);
@@ -89,6 +161,24 @@ void experiment(const std::vector<key_type> &keys,
         auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
         s_glob = lookup_accu;
 
+        // Batched lookup time.
+        std::vector<std::size_t> positions(samples.size());
+        start = steady_clock::now();
+        rmi.lower_bound_batch(samples.data(), samples.size(), keys.begin(), search_fn, positions.data());
+        stop = steady_clock::now();
+        auto batch_lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        std::size_t batch_lookup_accu = std::accumulate(positions.begin(), positions.end(), std::size_t(2));
+        s_glob = batch_lookup_accu;
+
+        // Interleaved lookup time.
+        start = steady_clock::now();
+        rmi::lower_bound_interleaved<Search>(rmi, samples.data(), samples.size(), keys.begin(), n_inflight,
+                                             positions.data());
+        stop = steady_clock::now();
+        auto coro_lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        std::size_t coro_lookup_accu = std::accumulate(positions.begin(), positions.end(), std::size_t(2));
+        s_glob = coro_lookup_accu;
+
         // Report results.
         // Dataset
         std::cout << dataset_name << ','
@@ -111,7 +201,16 @@ void experiment(const std::vector<key_type> &keys,
                   //                    << perf_no_<< ','
                   //                    << result
                   << predict_time << ','
-                  << search_time
+                  << search_time << ','
+                  // Batched lookups
+                  << batch_lookup_time << ','
+                  << batch_lookup_accu << ','
+                  // Interleaved lookups
+                  << n_inflight << ','
+                  << coro_lookup_time << ','
+                  << coro_lookup_accu << ','
+                  // Dataset loading
+                  << data_load_time
                   << std::endl;
     }
 }
@@ -119,7 +218,7 @@ void experiment(const std::vector<key_type> &keys,
 /**
  * @brief experiment function pointer
  */
-typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+typedef void (*exp_fn_ptr)(const keys_type&,
                            const std::size_t,
                            const std::vector<key_type>&,
                            const std::size_t,
@@ -127,7 +226,10 @@ typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
                            const std::string,
                            const std::string,
                            const std::string,
-                           const std::string);
+                           const std::string,
+                           const std::size_t,
+                           const bool,
+                           const long);
 
 /**
  * RMI configuration that holds the string representation of model types of layer 1 and layer 2, error bound type, and
@@ -203,6 +305,16 @@ struct ConfigCompare {
     { {#L1, #L2, "lind", "model_biased_binary_branchless"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedBinarySearch_Branchless> }, \
     { {#L1, #L2, "gabs", "model_biased_binary_branchless"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, ModelBiasedBinarySearch_Branchless> }, \
     { {#L1, #L2, "gind", "model_biased_binary_branchless"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedBinarySearch_Branchless> }, \
+    { {#L1, #L2, "labs_interleaved", "binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, rmi::InterleavedLayout<>>, BinarySearch> }, \
+    { {#L1, #L2, "lind_interleaved", "binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, rmi::InterleavedLayout<>>, BinarySearch> }, \
+    { {#L1, #L2, "labs_interleaved", "model_biased_binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, rmi::InterleavedLayout<>>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "lind_interleaved", "model_biased_binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, rmi::InterleavedLayout<>>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "labs_interleaved", "model_biased_exponential"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, rmi::InterleavedLayout<>>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "lind_interleaved", "model_biased_exponential"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, rmi::InterleavedLayout<>>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "labs_huge", "binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, rmi::SplitLayout, rmi::HugePageAllocator<LT2>>, BinarySearch> }, \
+    { {#L1, #L2, "lind_huge", "binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, rmi::SplitLayout, rmi::HugePageAllocator<LT2>>, BinarySearch> }, \
+    { {#L1, #L2, "labs_huge", "model_biased_binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, rmi::SplitLayout, rmi::HugePageAllocator<LT2>>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "lind_huge", "model_biased_binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, rmi::SplitLayout, rmi::HugePageAllocator<LT2>>, ModelBiasedBinarySearch> }, \
     
     
 
@@ -211,6 +323,7 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
     // ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
     // ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
     ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(fixed_linear_spline, fixed_linear_regression, rmi::FixedPoint<rmi::LinearSpline>, rmi::FixedPoint<rmi::LinearRegression>)
     // ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
     // ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
     // ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
@@ -235,17 +348,18 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("layer1")
-        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or "
+              "fixed_linear_spline.");
 
     program.add_argument("layer2")
-        .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
+        .help("layer2 model type, either linear_regression, linear_spline, cubic_spline, or fixed_linear_regression.");
 
     program.add_argument("n_models")
         .help("number of models on layer2, power of two is recommended.")
         .action([](const std::string &s) { return std::stoul(s); });
 
     program.add_argument("bound_type")
-        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+        .help("type of error bounds used, either none, labs, lind, gabs, gind, labs_interleaved, or lind_interleaved.");
 
     program.add_argument("search")
         .help("search algorithm for error correction, either binary, model_biased_binary, exponential, model_biased_exponential, linear, or model_biased_linear.");
@@ -260,6 +374,20 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(1'000'000))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-c", "--n_inflight")
+        .help("number of interleaved lookups in flight for coroutine-based lookups")
+        .default_value(std::size_t(16))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-l", "--loader")
+        .help("dataset loader, either read (ifstream), mmap, or pread (parallel reads into huge pages)")
+        .default_value(std::string("pread"));
+
+    program.add_argument("--check")
+        .help("check monotonicity and search bounds of the predictions before measuring")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -284,9 +412,20 @@ int main(int argc, char *argv[])
     const auto search = program.get<std::string>("search");
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto n_inflight = program.get<std::size_t>("-c");
+    if (n_inflight == 0) {
+        std::cerr << "Error: the number of lookups in flight must be at least 1." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const auto loader = program.get<std::string>("-l");
+    const auto check_rmi = program.get<bool>("--check");
 
     // Load keys.
-    auto keys = load_data<key_type>(filename);
+    auto start = steady_clock::now();
+    auto dataset = rmi::Dataset<key_type>::load(filename, loader);
+    auto stop = steady_clock::now();
+    auto data_load_time = duration_cast<nanoseconds>(stop - start).count();
+    auto keys = dataset.keys();
 
     // Sample keys.
     uint64_t seed = 42;
@@ -297,6 +436,10 @@ int main(int argc, char *argv[])
     for (std::size_t i = 0; i != n_samples; ++i)
         samples.push_back(keys[distrib(gen)]);
 
+    // Check a fixed-point layer2, which is centered on the first key of its segment, with empty leading segments.
+    if (check_rmi)
+        check_leading_segments<rmi::RmiLInd<key_type, rmi::LinearRegression, rmi::FixedPoint<rmi::LinearSpline>>>(keys);
+
     // Lookup experiment.
     Config config{layer1, layer2, bound_type, search};
     if (exp_map.find(config) == exp_map.end()) {
@@ -319,10 +462,19 @@ int main(int argc, char *argv[])
                   << "n_samples,"
                   << "lookup_time,"
                   << "lookup_accu,"
+                  << "predict_time,"
+                  << "search_time,"
+                  << "batch_lookup_time,"
+                  << "batch_lookup_accu,"
+                  << "n_inflight,"
+                  << "coro_lookup_time,"
+                  << "coro_lookup_accu,"
+                  << "data_load_time"
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, layer1, layer2, bound_type, search);
+    (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, layer1, layer2, bound_type, search, n_inflight,
+              check_rmi, data_load_time);
 
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,305 @@
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/numa.hpp"
+#include "rmi/util/search.hpp"
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Measures the lookup throughput of @p n_threads pinned threads on a single copy of a given @p Rmi and the keys, on
+ * one replica of the RMI per NUMA node, and on one replica of both the RMI and the keys per NUMA node. Threads are
+ * assigned to nodes round-robin. Results are written to `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @tparam Search search type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param samples for which the lookup time is measured, split evenly among threads
+ * @param n_threads number of lookup threads
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ * @param search used by the RMI for correction prediction errors
+ */
+template<typename Key, typename Rmi, typename Search>
+void experiment(const std::vector<key_type> &keys,
+                const std::size_t n_models,
+                const std::vector<key_type> &samples,
+                const std::size_t n_threads,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string search)
+{
+    using rmi_type = Rmi;
+    auto search_fn = Search();
+    const auto &topology = rmi::NumaTopology::get();
+    const std::size_t n_nodes = topology.n_nodes();
+
+    // Assign threads to CPUs round-robin over nodes.
+    std::vector<int> thread_cpus(n_threads);
+    for (std::size_t t = 0; t != n_threads; ++t) {
+        const auto &cpus = topology.cpus(t % n_nodes);
+        thread_cpus[t] = cpus[(t / n_nodes) % cpus.size()];
+    }
+
+    // Build a single copy of the RMI and the keys on the first node.
+    std::unique_ptr<rmi_type> single_rmi;
+    std::unique_ptr<std::vector<key_type>> single_keys;
+    std::thread builder([&]() {
+        rmi::pin_thread_to_node(0);
+        single_rmi = std::make_unique<rmi_type>(keys, n_models);
+        single_keys = std::make_unique<std::vector<key_type>>(keys);
+    });
+    builder.join();
+
+    // Build one replica of the RMI and the keys per node.
+    rmi::Replicated<rmi_type> replicated_rmi(keys, n_models);
+    rmi::Replicated<std::vector<key_type>> replicated_keys(keys);
+
+    const std::string replications[] = {"none", "index", "index_keys"};
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+        for (const auto &replication : replications) {
+
+            // Lookup time.
+            std::vector<std::size_t> lookup_accus(n_threads, 0);
+            auto start = steady_clock::now();
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t != n_threads; ++t) {
+                threads.emplace_back([&, t]() {
+                    rmi::pin_thread({thread_cpus[t]});
+                    const rmi_type &rmi = replication == "none" ? *single_rmi : replicated_rmi.local();
+                    const auto &data = replication == "index_keys" ? replicated_keys.local() : *single_keys;
+                    std::size_t begin = samples.size() * t / n_threads;
+                    std::size_t end = samples.size() * (t + 1) / n_threads;
+                    std::size_t lookup_accu = 0;
+                    for (std::size_t i = begin; i != end; ++i) {
+                        auto key = samples[i];
+                        auto range = rmi.search(key);
+                        auto pos = search_fn(data.begin() + range.lo, data.begin() + range.hi,
+                                             data.begin() + range.pos, key);
+                        lookup_accu += std::distance(data.begin(), pos);
+                    }
+                    lookup_accus[t] = lookup_accu;
+                });
+            }
+            for (auto &t : threads)
+                t.join();
+            auto stop = steady_clock::now();
+            auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+            std::size_t lookup_accu = std::accumulate(lookup_accus.begin(), lookup_accus.end(), std::size_t(0));
+            s_glob = lookup_accu;
+
+            // Report results.
+                      // Dataset
+            std::cout << dataset_name << ','
+                      << keys.size() << ','
+                      // Index
+                      << layer1 << ','
+                      << layer2 << ','
+                      << n_models << ','
+                      << bound_type << ','
+                      << search << ','
+                      << single_rmi->size_in_bytes() << ','
+                      // Experiment
+                      << n_nodes << ','
+                      << n_threads << ','
+                      << replication << ','
+                      << rep << ','
+                      << samples.size() << ','
+                      // Results
+                      << lookup_time << ','
+                      // Checksums
+                      << lookup_accu << std::endl;
+        } // replications
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2, error bound type, and
+ * search algorithm.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+    std::string search;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
+        return lhs.search < rhs.search;
+    }
+};
+
+#define ENTRIES(L1, L2, LT1, LT2) \
+    { {#L1, #L2, "none", "model_biased_exponential"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "labs", "binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, BinarySearch> }, \
+    { {#L1, #L2, "lind", "model_biased_binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "gabs", "binary"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, BinarySearch> }, \
+    { {#L1, #L2, "gind", "model_biased_binary"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedBinarySearch> },
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+#undef ENTRIES
+
+
+/**
+ * Triggers measurement of multi-threaded lookup throughput with and without NUMA replication for an RMI
+ * configuration provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_spline, cubic_spline, or radix.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, only linear_regression is supported.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("search")
+        .help("search algorithm for error correction, model_biased_exponential for none, binary for labs and gabs, "
+              "model_biased_binary for lind and gind.");
+
+    program.add_argument("-t", "--n_threads")
+        .help("number of lookup threads")
+        .default_value(std::size_t(std::max(std::thread::hardware_concurrency(), 1u)))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto search = program.get<std::string>("search");
+    const auto n_threads = program.get<std::size_t>("-t");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+
+    // Lookup experiment.
+    Config config{layer1, layer2, bound_type, search};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type << ',' << search
+                  << " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
+    std::vector<key_type> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        samples.push_back(keys[distrib(gen)]);
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "search,"
+                  << "size_in_bytes,"
+                  << "n_nodes,"
+                  << "n_threads,"
+                  << "replication,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, samples, n_threads, n_reps, dataset_name, layer1, layer2, bound_type, search);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/updatable_rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Type of an operation of the mixed workload.
+ */
+enum class OpType { read, insert, erase };
+
+/**
+ * Operation of the mixed workload.
+ */
+struct Op {
+    OpType type;
+    key_type key;
+};
+
+
+/**
+ * Measures the throughput of a mixed read/write workload and of a subsequent read-only workload on a given
+ * @p UpdatableRmi and compares the read-only workload against a static RMI with local absolute bounds. The index is
+ * built on every other key, the remaining keys are inserted by the workload. Results are written to `std::cout`.
+ * @tparam Key key type
+ * @tparam Layer1 model type of the first layer
+ * @tparam Layer2 model type of the second layer
+ * @param keys from which the index is built and the workload is drawn
+ * @param n_models number of models in the second layer of the RMI
+ * @param delta_threshold number of buffered updates after which a segment is retrained
+ * @param write_ratio fraction of operations of the mixed workload that are writes
+ * @param n_ops number of operations of each workload
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ */
+template<typename Key, typename Layer1, typename Layer2>
+void experiment(const std::vector<key_type> &keys,
+                const std::size_t n_models,
+                const std::size_t delta_threshold,
+                const double write_ratio,
+                const std::size_t n_ops,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string layer1,
+                const std::string layer2)
+{
+    using updatable_rmi_type = rmi::UpdatableRmi<Key, Layer1, Layer2>;
+    using static_rmi_type = rmi::RmiLAbs<Key, Layer1, Layer2>;
+
+    // Split keys into keys the index is built on and keys that are inserted later.
+    std::vector<key_type> base_keys, new_keys;
+    for (std::size_t i = 0; i != keys.size(); ++i)
+        (i % 2 == 0 ? base_keys : new_keys).push_back(keys[i]);
+
+    // Generate workloads.
+    uint64_t seed = 42;
+    std::mt19937 gen(seed);
+    std::shuffle(new_keys.begin(), new_keys.end(), gen);
+    std::uniform_int_distribution<std::size_t> key_distrib(0, keys.size() - 1);
+    std::bernoulli_distribution write_distrib(write_ratio);
+    std::vector<Op> mixed_ops, read_ops;
+    mixed_ops.reserve(n_ops);
+    read_ops.reserve(n_ops);
+    std::size_t n_writes = 0;
+    for (std::size_t i = 0; i != n_ops; ++i) {
+        if (write_distrib(gen)) {
+            if (n_writes++ % 2 == 0) // alternate inserts of new keys and deletes of random keys
+                mixed_ops.push_back({OpType::insert, new_keys[(n_writes / 2) % new_keys.size()]});
+            else
+                mixed_ops.push_back({OpType::erase, keys[key_distrib(gen)]});
+        } else {
+            mixed_ops.push_back({OpType::read, keys[key_distrib(gen)]});
+        }
+        read_ops.push_back({OpType::read, keys[key_distrib(gen)]});
+    }
+
+    // Build static RMI.
+    static_rmi_type static_rmi(base_keys, n_models);
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build updatable RMI.
+        updatable_rmi_type rmi(base_keys, n_models, delta_threshold);
+
+        // Mixed workload.
+        std::size_t checksum = 0;
+        auto start = steady_clock::now();
+        for (const Op &op : mixed_ops) {
+            switch (op.type) {
+                case OpType::read: checksum += rmi.contains(op.key); break;
+                case OpType::insert: checksum += rmi.insert(op.key); break;
+                case OpType::erase: checksum += rmi.erase(op.key); break;
+            }
+        }
+        auto stop = steady_clock::now();
+        auto mixed_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Read-only workload on the updated index.
+        start = steady_clock::now();
+        for (const Op &op : read_ops)
+            checksum += rmi.contains(op.key);
+        stop = steady_clock::now();
+        auto read_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Read-only workload on the static index.
+        start = steady_clock::now();
+        for (const Op &op : read_ops) {
+            auto range = static_rmi.search(op.key);
+            auto pos = std::lower_bound(base_keys.begin() + range.lo, base_keys.begin() + range.hi, op.key);
+            checksum += pos != base_keys.end() and *pos == op.key;
+        }
+        stop = steady_clock::now();
+        auto static_read_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = checksum;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << layer1 << ','
+                  << layer2 << ','
+                  << n_models << ','
+                  << delta_threshold << ','
+                  // Experiment
+                  << write_ratio << ','
+                  << rep << ','
+                  << n_ops << ','
+                  // Results
+                  << mixed_time << ','
+                  << read_time << ','
+                  << static_read_time << ','
+                  // Checksums
+                  << checksum << std::endl;
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::size_t,
+                           const double,
+                           const std::size_t,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        return lhs.layer2 < rhs.layer2;
+    }
+};
+
+#define ENTRIES(L1, L2, T1, T2) \
+    { {#L1, #L2}, &experiment<key_type, T1, T2> },
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+#undef ENTRIES
+
+
+/**
+ * Triggers measurement of mixed read/write throughput for an updatable RMI configuration provided via command line
+ * arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, only linear_regression is supported.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-d", "--delta_threshold")
+        .help("number of buffered updates after which a segment is retrained")
+        .default_value(std::size_t(256))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--write_ratio")
+        .help("fraction of operations of the mixed workload that are writes")
+        .default_value(double(0.1))
+        .action([](const std::string &s) { return std::stod(s); });
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_ops")
+        .help("number of operations of each workload")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto delta_threshold = program.get<std::size_t>("-d");
+    const auto write_ratio = program.get<double>("-w");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_ops = program.get<std::size_t>("-s");
+
+    // Update experiment.
+    Config config{layer1, layer2};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "delta_threshold,"
+                  << "write_ratio,"
+                  << "rep,"
+                  << "n_ops,"
+                  << "mixed_time,"
+                  << "read_time,"
+                  << "static_read_time,"
+                  << "checksum"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, delta_threshold, write_ratio, n_ops, n_reps, dataset_name, layer1, layer2);
+
+    exit(EXIT_SUCCESS);
+}
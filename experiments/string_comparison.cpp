@@ -0,0 +1,511 @@
+#include <iostream>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/string_rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/string_array.hpp"
+
+#include "art/art.hpp"
+
+#include "tlx/container/btree_multimap.hpp"
+
+
+using key_type = std::string;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/*======================================================================================================================
+ * Recursive Model Index
+ *====================================================================================================================*/
+
+/**
+ * Builds a string recursive model index of type @p Rmi with @p n_models models in layer2 on @p keys and performs
+ * @p n_reps of lookups on @p samples. Writes results including build time, evaluation time, and lookup time to
+ * `std::cout`.
+ * @tparam Rmi type of the index built on the mapped keys
+ * @tparam Search type of the search correcting prediction errors
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_models number of models in layer2
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param config_name name of the index configuration
+ */
+template<typename Rmi, typename Search>
+void run_rmi(const rmi::StringArray &keys,
+             const std::vector<key_type> &samples,
+             const std::size_t n_models,
+             const std::size_t n_reps,
+             const std::string dataset_name,
+             const std::string config_name)
+{
+    auto search_fn = Search();
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build time.
+        auto start = steady_clock::now();
+        rmi::StringRmi<Rmi> rmi(keys, n_models);
+        auto stop = steady_clock::now();
+        auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Eval time.
+        std::size_t eval_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            std::string_view key = samples[i];
+            auto range = rmi.search(key);
+            eval_accu += range.pos + range.lo + range.hi;
+        }
+        stop = steady_clock::now();
+        auto eval_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = eval_accu;
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            std::string_view key = samples[i];
+            lookup_accu += rmi.lower_bound(keys, key, search_fn);
+        }
+        stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << "RMI-ours" << ','
+                  << "\"" << config_name << ",layer2_size=" << n_models << "\"" << ','
+                  << rmi.size_in_bytes() << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  // Results
+                  << build_time << ','
+                  << eval_time << ','
+                  << lookup_time << ','
+                  // Checksums
+                  << eval_accu << ','
+                  << lookup_accu << std::endl;
+    } // reps
+}
+
+/**
+ * Builds string recursive model indexes of different size on @p keys and performs @p n_reps of lookups on @p samples.
+ * Writes results including build time, evaluation time, and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ */
+void benchmark_rmi(const rmi::StringArray &keys,
+                   const std::vector<key_type> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name)
+{
+    // Set hyperparameters.
+    using layer1_type = rmi::LinearSpline;
+    using layer2_type = rmi::LinearRegression;
+
+    // Benchmark each configuration.
+    for (std::size_t k = 8; k <= 24; k += 2) {
+        std::size_t n_models = 1UL << k;
+        if (n_models > keys.size()) break;
+
+        run_rmi<rmi::Rmi<uint64_t, layer1_type, layer2_type>, ModelBiasedExponentialSearch>(
+            keys, samples, n_models, n_reps, dataset_name, "rmi::Rmi");
+        run_rmi<rmi::RmiLAbs<uint64_t, layer1_type, layer2_type>, BinarySearch>(
+            keys, samples, n_models, n_reps, dataset_name, "rmi::RmiLAbs");
+        run_rmi<rmi::RmiLInd<uint64_t, layer1_type, layer2_type>, ModelBiasedBinarySearch>(
+            keys, samples, n_models, n_reps, dataset_name, "rmi::RmiLInd");
+    }
+}
+
+
+/*======================================================================================================================
+ * Adaptive Radix Tree
+ *====================================================================================================================*/
+
+/**
+ * Builds Adaptive Radix Trees of different size on @p keys and performs @p n_reps of lookups on @p samples. Writes
+ * results including build time, evaluation time, and lookup time to `std::cout`.
+ *
+ * ART only supports 8-byte keys, so it is built on the same order-preserving 8-byte key prefixes as the RMI. It
+ * returns the position of the first indexed key whose prefix is not less than the prefix of the lookup key. Since
+ * keys may share a prefix, the last-mile search is an exponential search to the right of that position.
+ *
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ */
+void benchmark_art(const rmi::StringArray &keys,
+                   const std::vector<key_type> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name)
+{
+    // Set hyperparameters.
+    std::size_t min_sparcity = 0;
+    std::size_t max_sparcity = 14;
+
+    // Benchmark each configuration.
+    for (std::size_t k = min_sparcity; k <= max_sparcity; k++) {
+        std::size_t sparcity = 1UL << k;
+        auto search_fn = ExponentialSearch();
+
+        // Perform n_reps runs.
+        for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+            // Build time.
+            auto start = steady_clock::now();
+            rmi::StringPrefix prefix(keys[0], keys[keys.size() - 1]);
+            std::vector<art::KeyValue<uint64_t, std::size_t>> dataset;
+            dataset.reserve(keys.size());
+            for (std::size_t i = 0; i != keys.size(); ++i)
+                dataset.push_back({prefix.encode(keys[i]), i});
+            art::ART art(dataset, sparcity);
+            auto stop = steady_clock::now();
+            auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+            // Eval time.
+            std::size_t eval_accu = 0;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                auto range = art.search(prefix.encode(samples[i]));
+                eval_accu += range.first + range.second;
+            }
+            stop = steady_clock::now();
+            auto eval_time = duration_cast<nanoseconds>(stop - start).count();
+            s_glob = eval_accu;
+
+            // Lookup time.
+            std::size_t lookup_accu = 0;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                std::string_view key = samples[i];
+                auto range = art.search(prefix.encode(key));
+                auto pos = search_fn(keys.begin() + range.first, keys.end(), keys.begin() + range.first, key);
+                lookup_accu += std::distance(keys.begin(), pos);
+            }
+            stop = steady_clock::now();
+            auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+            s_glob = lookup_accu;
+
+            // Report results.
+                      // Dataset
+            std::cout << dataset_name << ','
+                      << keys.size() << ','
+                      // Index
+                      << "ART" << ','
+                      << "\"sparcity=" << sparcity << "\"" << ','
+                      << art.size_in_bytes() + prefix.size_in_bytes() << ','
+                      // Experiment
+                      << rep << ','
+                      << samples.size() << ','
+                      // Results
+                      << build_time << ','
+                      << eval_time << ','
+                      << lookup_time << ','
+                      // Checksums
+                      << eval_accu << ','
+                      << lookup_accu << std::endl;
+        } // rep
+    } // sparcity
+}
+
+
+/*======================================================================================================================
+ * B-tree
+ *====================================================================================================================*/
+
+/**
+ * Builds B-trees of different size on @p keys and performs @p n_reps of lookups on @p samples. Writes results including
+ * build time, evaluation time, and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ */
+void benchmark_tlx(const rmi::StringArray &keys,
+                   const std::vector<key_type> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name)
+{
+    // Set hyperparameters.
+    std::size_t min_sparcity = 0;
+    std::size_t max_sparcity = 14;
+
+    // Benchmark each configuration.
+    for (std::size_t k = min_sparcity; k <= max_sparcity; k++) {
+        std::size_t sparcity = 1UL << k;
+
+        // Prepare dataset.
+        std::vector<std::pair<key_type, std::size_t>> dataset;
+        dataset.reserve(keys.size() / sparcity);
+        std::size_t key_heap_size = 0; // characters of keys that do not fit into std::string
+        for (std::size_t i = 0; i != keys.size(); ++i) {
+            if (i % sparcity == 0) {
+                dataset.emplace_back(keys[i], i);
+                if (dataset.back().first.capacity() >= sizeof(key_type))
+                    key_heap_size += dataset.back().first.capacity() + 1;
+            }
+        }
+
+        // Perform n_reps runs.
+        for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+            // Build time.
+            auto start = steady_clock::now();
+            tlx::btree_multimap<key_type, std::size_t> btree;
+            btree.bulk_load(dataset.begin(), dataset.end());
+            auto stop = steady_clock::now();
+            auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+            // Eval time.
+            std::size_t eval_accu = 0;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                auto &key = samples[i];
+                auto it = btree.lower_bound(key);
+                auto res = it == btree.end() ? keys.size() - 1 : it->second;
+                eval_accu += res;
+            }
+            stop = steady_clock::now();
+            auto eval_time = duration_cast<nanoseconds>(stop - start).count();
+            s_glob = eval_accu;
+
+            // Lookup time.
+            std::size_t lookup_accu = 0;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                auto &key = samples[i];
+                auto it = btree.lower_bound(key);
+                auto res = it == btree.end() ? keys.size() - 1 : it->second;
+                auto lo = res < sparcity - 1 ? 0 : res - (sparcity - 1);
+                auto hi = std::min<std::size_t>(keys.size(), res + 1);
+                auto pos = std::lower_bound(keys.begin() + lo, keys.begin() + hi, std::string_view(key));
+                lookup_accu += std::distance(keys.begin(), pos);
+            }
+            stop = steady_clock::now();
+            auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+            s_glob = lookup_accu;
+
+            // Compute size.
+            auto stats = btree.get_stats();
+            auto inner_slots = stats.inner_slots;
+            auto n_inner_nodes = stats.inner_nodes;
+            auto inner_node_size = inner_slots * sizeof(key_type) + (inner_slots + 1) * sizeof(void*); // keys and pointers
+
+            auto leaf_slots = stats.leaf_slots;
+            auto n_leaves = stats.leaves;
+            auto leaf_size = 2 * sizeof(void*) + leaf_slots * (sizeof(key_type) + sizeof(uint64_t)); // prev/next + data
+
+            double size_in_bytes = inner_node_size * n_inner_nodes + leaf_size * n_leaves + key_heap_size;
+
+            // Report results.
+                      // Dataset
+            std::cout << dataset_name << ','
+                      << keys.size() << ','
+                      // Index
+                      << "B-tree" << ','
+                      << "\"sparcity=" << sparcity << "\"" << ','
+                      << size_in_bytes << ','
+                      // Experiment
+                      << rep << ','
+                      << samples.size() << ','
+                      // Results
+                      << build_time << ','
+                      << eval_time << ','
+                      << lookup_time << ','
+                      // Checksums
+                      << eval_accu << ','
+                      << lookup_accu << std::endl;
+        } // rep
+    } // k
+}
+
+
+/*======================================================================================================================
+ * Binary Search
+ *====================================================================================================================*/
+
+/**
+ * Performs @p n_reps of binary search lookups on @p samples. Writes results including build time, evaluation time, and
+ * lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ */
+void benchmark_bin(const rmi::StringArray &keys,
+                   const std::vector<key_type> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name)
+{
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build time.
+        std::size_t build_time = 0;
+
+        // Eval time.
+        std::size_t eval_accu = 0;
+        std::size_t eval_time = 0;
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            std::string_view key = samples[i];
+            auto pos = std::lower_bound(keys.begin(), keys.end(), key);
+            lookup_accu += std::distance(keys.begin(), pos);
+        }
+        auto stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Compute size.
+        double size_in_bytes = 0.f;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << "\"Binary search\"" << ','
+                  << "\"\"" << ','
+                  << size_in_bytes << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  // Results
+                  << build_time << ','
+                  << eval_time << ','
+                  << lookup_time << ','
+                  // Checksums
+                  << eval_accu << ','
+                  << lookup_accu << std::endl;
+    } // rep
+}
+
+/**
+ * Performs an index comparison on string keys in terms of build time, evaluation time, and lookup time.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to text file containing one string key per line");
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--rmi")
+        .help("run benchmark on Recursive Model Index")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--art")
+        .help("run benchmark on Adaptive Radix Tree")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--tlx")
+        .help("run benchmark on TLX B-tree")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--bin")
+        .help("run benchmark on binary search")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+
+    // Load and sort keys.
+    auto strings = load_strings(filename);
+    if (strings.empty()) {
+        std::cerr << "Error: " << filename << " contains no keys." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::sort(strings.begin(), strings.end());
+
+    // Sample keys.
+    uint64_t seed = 42;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> distrib(0, strings.size() - 1);
+    std::vector<key_type> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        samples.push_back(strings[distrib(gen)]);
+
+    // Pack keys.
+    rmi::StringArray keys(strings);
+    strings.clear();
+    strings.shrink_to_fit();
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "index,"
+                  << "config,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "build_time,"
+                  << "eval_time,"
+                  << "lookup_time,"
+                  << "eval_accu,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run benchmarks.
+    if (program["--rmi"]  == true) benchmark_rmi(keys, samples, n_reps, dataset_name);
+    if (program["--art"]  == true) benchmark_art(keys, samples, n_reps, dataset_name);
+    if (program["--tlx"]  == true) benchmark_tlx(keys, samples, n_reps, dataset_name);
+    if (program["--bin"]  == true) benchmark_bin(keys, samples, n_reps, dataset_name);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/**
+ * Builds an index of type @p Index on a stream of sorted keys that are pushed one at a time or in batches, e.g., the
+ * output of an external merge, without holding all keys in memory.
+ *
+ * Since segments are determined by layer1, it is trained before the first key arrives, either on a sample of the keys,
+ * e.g., every k-th key of the merged inputs, or handed as a trained model, e.g., the layer1 of the index being
+ * replaced. Keys are assigned to segments as they arrive. Whenever a key crosses a segment boundary, the layer2 model
+ * of the finished segment is trained on its distinct keys and their error bounds are computed. Thus, only the current
+ * segment is buffered and peak memory is the size of the index plus the largest segment, instead of all keys.
+ *
+ * The final number of keys is unknown while streaming, but position estimates are clamped to the last position. Thus,
+ * error bounds are computed both on estimates clamped to the last expected position and on unclamped estimates. If
+ * no more keys than expected were pushed, the former are used, which equal the bounds computed by the index itself if
+ * the expected number of keys was exact. Otherwise, the latter are used, which are never smaller than necessary, so
+ * lookups are correct in either case.
+ *
+ * @tparam Index the type of the index to build, e.g., RmiLAbs<uint64_t, LinearSpline, LinearRegression>
+ */
+template<typename Index>
+class RmiBuilder
+{
+    using key_type = typename Index::key_type;
+    using layer1_type = typename Index::layer1_type;
+    using layer2_type = typename Index::layer2_type;
+
+    Index index_;                                  ///< The index under construction.
+    std::size_t max_pos_;                          ///< The last expected position.
+    std::size_t n_keys_ = 0;                       ///< The number of keys pushed so far.
+    std::size_t segment_id_ = 0;                   ///< The id of the current segment.
+    key_type last_key_ = key_type();               ///< The last key pushed.
+    std::vector<key_type> distinct_;               ///< The distinct keys of the current segment.
+    std::vector<std::size_t> positions_;           ///< The positions of the first occurrences of the distinct keys.
+    std::vector<std::size_t> errors_lo_;           ///< The largest overestimation of each segment.
+    std::vector<std::size_t> errors_hi_;           ///< The largest underestimation of each segment.
+    std::vector<std::size_t> unclamped_errors_lo_; ///< The largest unclamped overestimation of each segment.
+    std::vector<std::size_t> unclamped_errors_hi_; ///< The largest unclamped underestimation of each segment.
+
+    public:
+    /**
+     * Prepares building an index with @p layer2_size models in layer2 on about @p n_keys keys. Layer1 is trained on the
+     * sorted @p sample of the keys, where the i-th of m sampled keys is assumed at position i * (n_keys - 1) / (m - 1),
+     * i.e., the sample should be evenly spaced and include the smallest and the largest key.
+     * @param sample vector of sorted keys sampled from the keys to be indexed
+     * @param n_keys the expected number of keys
+     * @param layer2_size the number of models in layer2
+     */
+    RmiBuilder(const std::vector<key_type> &sample, const std::size_t n_keys, const std::size_t layer2_size)
+        : RmiBuilder(train_layer1(sample, n_keys, layer2_size), n_keys, layer2_size) { }
+
+    /**
+     * Prepares building an index with @p layer2_size models in layer2 on about @p n_keys keys using the trained layer1
+     * model @p l1, which is expected to map keys to segment ids in [0, layer2_size).
+     * @param l1 the layer1 model
+     * @param n_keys the expected number of keys
+     * @param layer2_size the number of models in layer2
+     */
+    RmiBuilder(const layer1_type &l1, const std::size_t n_keys, const std::size_t layer2_size)
+        : max_pos_(std::max<std::size_t>(n_keys, 1) - 1)
+        , errors_lo_(layer2_size, 0)
+        , errors_hi_(layer2_size, 0)
+        , unclamped_errors_lo_(layer2_size, 0)
+        , unclamped_errors_hi_(layer2_size, 0)
+    {
+        index_.allocate_layers(l1, layer2_size);
+    }
+
+    /**
+     * Appends @p key, which must not be less than the previously pushed key.
+     * @param key to append
+     */
+    void push(const key_type key) {
+        std::size_t segment_id = index_.get_segment_id(key);
+        if (segment_id > segment_id_) { // the key starts a new segment, train all models up to it
+            if (n_keys_ == 0) {
+                for (std::size_t j = 0; j < segment_id; ++j)
+                    new (&index_.l2_[j]) layer2_type(&key, &key + 1, 0); // train leading models on first key
+            } else {
+                train_segment();
+                for (std::size_t j = segment_id_ + 1; j < segment_id; ++j) {
+                    // Train models of empty segments on last key in previous segment.
+                    new (&index_.l2_[j]) layer2_type(&last_key_, &last_key_ + 1, n_keys_ - 1);
+                }
+            }
+            segment_id_ = segment_id;
+        }
+        if (distinct_.empty() or key != distinct_.back()) { // first occurrence
+            distinct_.push_back(key);
+            positions_.push_back(n_keys_);
+        }
+        last_key_ = key;
+        ++n_keys_;
+    }
+
+    /**
+     * Appends the @p n sorted @p keys, the first of which must not be less than the previously pushed key.
+     * @param keys array of sorted keys to append
+     * @param n number of keys
+     */
+    void push_batch(const key_type *keys, const std::size_t n) {
+        for (std::size_t i = 0; i != n; ++i) push(keys[i]);
+    }
+
+    /**
+     * Trains the models of the last segment and of the empty segments following it and returns the index. At least
+     * one key must have been pushed. The builder must not be used afterwards.
+     * @return the index on all pushed keys
+     */
+    Index finish() {
+        train_segment();
+        for (std::size_t j = segment_id_ + 1; j < index_.layer2_size_; ++j)
+            new (&index_.l2_[j]) layer2_type(&last_key_, &last_key_ + 1, n_keys_ - 1); // train remaining models
+        index_.n_keys_ = n_keys_;
+        if (n_keys_ - 1 <= max_pos_) index_.assign_bounds(errors_lo_, errors_hi_);
+        else index_.assign_bounds(unclamped_errors_lo_, unclamped_errors_hi_);
+        return std::move(index_);
+    }
+
+    /**
+     * Returns the number of keys pushed so far.
+     * @return the number of keys pushed so far
+     */
+    std::size_t n_keys() const { return n_keys_; }
+
+    private:
+    /**
+     * Trains layer1 with @p layer2_size segments on the sorted @p sample of about @p n_keys keys.
+     * @param sample vector of sorted keys sampled from the keys to be indexed
+     * @param n_keys the expected number of keys
+     * @param layer2_size the number of models in layer2
+     * @return the layer1 model
+     */
+    static layer1_type train_layer1(const std::vector<key_type> &sample, const std::size_t n_keys,
+                                    const std::size_t layer2_size) {
+        const std::size_t m = sample.size();
+        std::vector<std::size_t> positions(m, 0);
+        for (std::size_t i = 1; i < m; ++i)
+            positions[i] = static_cast<std::size_t>(static_cast<double>(i) * (n_keys - 1) / (m - 1));
+        return layer1_type(sample.begin(), sample.end(), positions.begin(), positions.end(),
+                           static_cast<double>(layer2_size) / n_keys); // train with compression
+    }
+
+    /**
+     * Trains the layer2 model of the current segment on its distinct keys, computes its error bounds, and clears the
+     * buffers of the segment.
+     */
+    void train_segment() {
+        auto &model = index_.l2_[segment_id_];
+        new (&model) layer2_type(distinct_.begin(), distinct_.end(), positions_.begin(), positions_.end(), 1.);
+        for (std::size_t i = 0; i != distinct_.size(); ++i) {
+            std::size_t pos = positions_[i];
+            std::size_t pred = clamp_prediction(model.predict(distinct_[i]), std::numeric_limits<std::int64_t>::max());
+            update_errors(std::min(pred, max_pos_), pos, errors_lo_, errors_hi_);
+            update_errors(pred, pos, unclamped_errors_lo_, unclamped_errors_hi_);
+        }
+        distinct_.clear();
+        positions_.clear();
+    }
+
+    /**
+     * Extends the error bounds of the current segment in @p errors_lo and @p errors_hi by the error of the position
+     * estimate @p pred of a key at position @p pos.
+     * @param pred the position estimate
+     * @param pos the position of the key
+     * @param errors_lo, errors_hi the largest over- and underestimation of each segment
+     */
+    void update_errors(const std::size_t pred, const std::size_t pos, std::vector<std::size_t> &errors_lo,
+                       std::vector<std::size_t> &errors_hi) const {
+        if (pred > pos) { // overestimation
+            errors_lo[segment_id_] = std::max(errors_lo[segment_id_], pred - pos);
+        } else { // underestimation
+            errors_hi[segment_id_] = std::max(errors_hi[segment_id_], pos - pred);
+        }
+    }
+};
+
+} // namespace rmi
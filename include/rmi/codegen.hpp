@@ -0,0 +1,402 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Models
+ *====================================================================================================================*/
+
+/**
+ * A parameter of a model in generated code.
+ */
+struct GeneratedParameter
+{
+    std::string type;  ///< The C++ type of the parameter.
+    std::string name;  ///< The name of the parameter.
+    std::string value; ///< The literal of the parameter value.
+};
+
+/**
+ * Returns a C++ literal that represents @p v exactly, i.e., a hexadecimal floating-point literal.
+ * @param v the value
+ * @return the literal
+ */
+inline std::string double_literal(const double v)
+{
+    if (std::isnan(v)) return "std::numeric_limits<double>::quiet_NaN()";
+    if (std::isinf(v)) return (v < 0 ? "-" : "") + std::string("std::numeric_limits<double>::infinity()");
+    std::ostringstream out;
+    out << std::hexfloat << v;
+    return out.str();
+}
+
+/**
+ * Describes how models of type @p Model are emitted as C++ code. Models without specialization, e.g., fixed-point
+ * models, cannot be emitted.
+ *
+ * Each specialization provides the name of the model, its parameters, and the expression of its prediction in terms
+ * of the key `key`, the key converted to double `x`, and its parameters prefixed by a given qualifier. The expression
+ * must compute the same value as the model's predict().
+ */
+template<typename Model>
+struct model_code;
+
+/**
+ * Emits linear models, i.e., LinearSpline and LinearRegression.
+ * @tparam Model the type of the linear model
+ */
+template<typename Model>
+struct linear_model_code
+{
+    static std::vector<GeneratedParameter> parameters(const Model &m) {
+        return {{"double", "slope", double_literal(m.slope())}, {"double", "intercept", double_literal(m.intercept())}};
+    }
+    static std::string predict(const std::string &p) { return "std::fma(" + p + "slope, x, " + p + "intercept)"; }
+    static constexpr bool uses_pext = false;
+};
+
+template<>
+struct model_code<LinearSpline> : linear_model_code<LinearSpline>
+{
+    static constexpr const char *name = "LinearSpline";
+};
+
+template<>
+struct model_code<LinearRegression> : linear_model_code<LinearRegression>
+{
+    static constexpr const char *name = "LinearRegression";
+};
+
+template<>
+struct model_code<CubicSpline>
+{
+    static constexpr const char *name = "CubicSpline";
+    static std::vector<GeneratedParameter> parameters(const CubicSpline &m) {
+        return {{"double", "a", double_literal(m.a())}, {"double", "b", double_literal(m.b())},
+                {"double", "c", double_literal(m.c())}, {"double", "d", double_literal(m.d())}};
+    }
+    static std::string predict(const std::string &p) {
+        return "std::fma(std::fma(std::fma(" + p + "a, x, " + p + "b), x, " + p + "c), x, " + p + "d)";
+    }
+    static constexpr bool uses_pext = false;
+};
+
+template<>
+struct model_code<Radix<std::uint64_t>>
+{
+    static constexpr const char *name = "Radix";
+    static std::vector<GeneratedParameter> parameters(const Radix<std::uint64_t> &m) {
+        return {{"std::uint64_t", "mask", std::to_string(m.mask()) + "ULL"}};
+    }
+    static std::string predict(const std::string &p) { return "static_cast<double>(_pext_u64(key, " + p + "mask))"; }
+    static constexpr bool uses_pext = true;
+};
+
+
+/*======================================================================================================================
+ * Code Generation
+ *====================================================================================================================*/
+
+/**
+ * The kinds of error bounds of generated indexes.
+ */
+enum class GeneratedBounds { none, global_abs, global_ind, local_abs, local_ind };
+
+/**
+ * Writes a header/source pair of a standalone index in namespace @p name to @p header and @p source. The layer1
+ * parameters are compile-time constants, the layer2 models and their local error bounds are a static array of
+ * aligned records, and the lookup is an inline function in the header so that it is compiled into the caller.
+ *
+ * The generated namespace offers `search(key)`, which returns the same position estimate and search bounds as the
+ * index it was generated from, and the interface of the reference implementation, i.e., `load()`, `cleanup()`,
+ * `lookup(key, &err)`, `RMI_SIZE`, and `BUILD_TIME_NS`, so that it can replace a reference RMI.
+ * @param l1 the layer1 model
+ * @param layer2 function returning the layer2 model of a segment
+ * @param errors function returning the lower and upper error bound of a segment
+ * @param bounds the kind of error bounds
+ * @param n_keys the number of keys the index was built on
+ * @param layer2_size the number of models in layer2
+ * @param description of the index the code is generated from
+ * @param name the namespace of the generated index, must be a valid C++ identifier
+ * @param build_time_ns the build time of the index in nanoseconds
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ */
+template<typename Layer1, typename Layer2Fn, typename ErrorsFn>
+void generate_code(const Layer1 &l1, Layer2Fn layer2, ErrorsFn errors, const GeneratedBounds bounds,
+                   const std::size_t n_keys, const std::size_t layer2_size, const std::string &description,
+                   const std::string &name, const std::uint64_t build_time_ns, std::ostream &header,
+                   std::ostream &source)
+{
+    using layer1_code = model_code<Layer1>;
+    using layer2_type = std::decay_t<decltype(layer2(0))>;
+    using layer2_code = model_code<layer2_type>;
+
+    const bool is_local = bounds == GeneratedBounds::local_abs or bounds == GeneratedBounds::local_ind;
+    const bool is_ind = bounds == GeneratedBounds::global_ind or bounds == GeneratedBounds::local_ind;
+
+    // Determine the type of local error bounds.
+    std::size_t max_error = 0;
+    if (is_local) {
+        for (std::size_t i = 0; i != layer2_size; ++i) {
+            auto [lo, hi] = errors(i);
+            max_error = std::max({max_error, lo, hi});
+        }
+    }
+    const std::size_t error_size = next_power_of_two((bit_width<std::size_t>(max_error | 1) + 7) / 8); // 1, 2, 4, or 8
+    const std::string error_type = "std::uint" + std::to_string(8 * error_size) + "_t";
+
+    // Determine the size and alignment of layer2 records.
+    auto l2_params = layer2_code::parameters(layer2(0));
+    std::size_t record_size = l2_params.size() * sizeof(double);
+    if (is_local) record_size += (is_ind ? 2 : 1) * error_size;
+    const std::size_t alignment = std::min<std::size_t>(next_power_of_two(record_size), 64);
+
+    /* Header. */
+    header << "#pragma once\n\n"
+           << "#include <algorithm>\n"
+           << "#include <cmath>\n"
+           << "#include <cstddef>\n"
+           << "#include <cstdint>\n"
+           << "#include <limits>\n";
+    if (layer1_code::uses_pext) header << "#include <x86intrin.h>\n";
+    header << "\n"
+           << "// Generated from " << description << " with " << layer2_size << " layer2 models on " << n_keys
+           << " keys.\n"
+           << "namespace " << name << " {\n\n"
+           << "constexpr std::size_t N_KEYS = " << n_keys << ";\n"
+           << "constexpr std::size_t LAYER2_SIZE = " << layer2_size << ";\n"
+           << "constexpr std::uint64_t BUILD_TIME_NS = " << build_time_ns << ";\n\n";
+
+    // Layer1 parameters.
+    header << "namespace layer1 {\n";
+    for (auto &p : layer1_code::parameters(l1))
+        header << "constexpr " << p.type << ' ' << p.name << " = " << p.value << ";\n";
+    header << "}\n\n";
+
+    // Global error bounds.
+    if (bounds == GeneratedBounds::global_abs) {
+        header << "constexpr std::size_t error = " << errors(0).first << ";\n\n";
+    } else if (bounds == GeneratedBounds::global_ind) {
+        header << "constexpr std::size_t error_lo = " << errors(0).first << ";\n"
+               << "constexpr std::size_t error_hi = " << errors(0).second << ";\n\n";
+    }
+
+    // Layer2 records.
+    header << "struct alignas(" << alignment << ") Layer2\n{\n";
+    for (auto &p : l2_params)
+        header << "    " << p.type << ' ' << p.name << ";\n";
+    if (bounds == GeneratedBounds::local_abs)
+        header << "    " << error_type << " error;\n";
+    else if (bounds == GeneratedBounds::local_ind)
+        header << "    " << error_type << " error_lo;\n    " << error_type << " error_hi;\n";
+    header << "};\n\n"
+           << "extern const Layer2 layer2[LAYER2_SIZE];\n\n";
+
+    // Size.
+    header << "constexpr std::size_t RMI_SIZE = ";
+    for (auto &p : layer1_code::parameters(l1))
+        header << "sizeof(layer1::" << p.name << ") + ";
+    if (bounds == GeneratedBounds::global_abs) header << "sizeof(error) + ";
+    else if (bounds == GeneratedBounds::global_ind) header << "sizeof(error_lo) + sizeof(error_hi) + ";
+    header << "LAYER2_SIZE * sizeof(Layer2);\n\n";
+
+    // Lookup.
+    const std::string lo_error = is_local ? (is_ind ? "m.error_lo" : "m.error") : (is_ind ? "error_lo" : "error");
+    const std::string hi_error = is_local ? (is_ind ? "m.error_hi" : "m.error") : (is_ind ? "error_hi" : "error");
+    header << "/**\n"
+           << " * Position estimate and search bounds [lo, hi) of a key.\n"
+           << " */\n"
+           << "struct Approx\n{\n"
+           << "    std::size_t pos;\n"
+           << "    std::size_t lo;\n"
+           << "    std::size_t hi;\n"
+           << "};\n\n"
+           << "/**\n"
+           << " * Returns a position estimate and search bounds for @p key.\n"
+           << " */\n"
+           << "inline Approx search(const std::uint64_t key)\n{\n"
+           << "    [[maybe_unused]] const double x = static_cast<double>(key);\n"
+           << "    const std::size_t segment_id = std::clamp<double>(" << layer1_code::predict("layer1::")
+           << ", 0, LAYER2_SIZE - 1);\n"
+           << "    const Layer2 &m = layer2[segment_id];\n"
+           << "    const std::size_t pos = std::clamp<double>(" << layer2_code::predict("m.") << ", 0, N_KEYS - 1);\n";
+    if (bounds == GeneratedBounds::none) {
+        header << "    return {pos, 0, N_KEYS};\n";
+    } else {
+        header << "    const std::size_t lo = pos > " << lo_error << " ? pos - " << lo_error << " : 0;\n"
+               << "    const std::size_t hi = std::min<std::size_t>(pos + " << hi_error << " + 1, N_KEYS);\n"
+               << "    return {pos, lo, hi};\n";
+    }
+    header << "}\n\n"
+           << "/**\n"
+           << " * Returns a position estimate for @p key and writes the distance to the farther bound to @p err.\n"
+           << " */\n"
+           << "inline std::uint64_t lookup(const std::uint64_t key, std::size_t *err)\n{\n"
+           << "    const Approx range = search(key);\n"
+           << "    *err = std::max(range.pos - range.lo, range.hi - range.pos);\n"
+           << "    return range.pos;\n"
+           << "}\n\n"
+           << "/**\n"
+           << " * Does nothing since all parameters are compiled in, exists for compatibility with reference RMIs.\n"
+           << " */\n"
+           << "inline bool load(const char *) { return true; }\n\n"
+           << "/**\n"
+           << " * Does nothing since all parameters are compiled in, exists for compatibility with reference RMIs.\n"
+           << " */\n"
+           << "inline void cleanup() { }\n\n"
+           << "} // namespace " << name << '\n';
+
+    /* Source. */
+    source << "#include \"" << name << ".h\"\n\n"
+           << "namespace " << name << " {\n\n"
+           << "const Layer2 layer2[LAYER2_SIZE] = {\n";
+    for (std::size_t i = 0; i != layer2_size; ++i) {
+        source << "    {";
+        for (auto &p : layer2_code::parameters(layer2(i)))
+            source << p.value << ", ";
+        if (is_local) {
+            auto [lo, hi] = errors(i);
+            if (is_ind) source << lo << ", " << hi;
+            else source << lo;
+        }
+        source << "},\n";
+    }
+    source << "};\n\n"
+           << "} // namespace " << name << '\n';
+}
+
+/**
+ * Generates code for recursive model index @p rmi without error bounds, see #generate_code().
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Layer1, typename Layer2, typename Allocator>
+void generate(const Rmi<std::uint64_t, Layer1, Layer2, Allocator> &rmi, const std::string &name, std::ostream &header,
+              std::ostream &source, const std::uint64_t build_time_ns = 0)
+{
+    auto description = std::string("rmi::Rmi<") + model_code<Layer1>::name + ", " + model_code<Layer2>::name + ">";
+    auto errors = [](std::size_t) { return std::make_pair(std::size_t(0), std::size_t(0)); };
+    generate_code(rmi.layer1(), [&](std::size_t i) -> const Layer2 & { return rmi.layer2(i); }, errors,
+                  GeneratedBounds::none, rmi.n_keys(), rmi.layer2_size(), description, name, build_time_ns, header,
+                  source);
+}
+
+/**
+ * Generates code for recursive model index @p rmi with global absolute bounds, see #generate_code().
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Layer1, typename Layer2, typename Allocator>
+void generate(const RmiGAbs<std::uint64_t, Layer1, Layer2, Allocator> &rmi, const std::string &name,
+              std::ostream &header, std::ostream &source, const std::uint64_t build_time_ns = 0)
+{
+    auto description = std::string("rmi::RmiGAbs<") + model_code<Layer1>::name + ", " + model_code<Layer2>::name + ">";
+    auto errors = [&](std::size_t) { return std::make_pair(rmi.error(), rmi.error()); };
+    generate_code(rmi.layer1(), [&](std::size_t i) -> const Layer2 & { return rmi.layer2(i); }, errors,
+                  GeneratedBounds::global_abs, rmi.n_keys(), rmi.layer2_size(), description, name, build_time_ns,
+                  header, source);
+}
+
+/**
+ * Generates code for recursive model index @p rmi with global individual bounds, see #generate_code().
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Layer1, typename Layer2, typename Allocator>
+void generate(const RmiGInd<std::uint64_t, Layer1, Layer2, Allocator> &rmi, const std::string &name,
+              std::ostream &header, std::ostream &source, const std::uint64_t build_time_ns = 0)
+{
+    auto description = std::string("rmi::RmiGInd<") + model_code<Layer1>::name + ", " + model_code<Layer2>::name + ">";
+    auto errors = [&](std::size_t) { return std::make_pair(rmi.error_lo(), rmi.error_hi()); };
+    generate_code(rmi.layer1(), [&](std::size_t i) -> const Layer2 & { return rmi.layer2(i); }, errors,
+                  GeneratedBounds::global_ind, rmi.n_keys(), rmi.layer2_size(), description, name, build_time_ns,
+                  header, source);
+}
+
+/**
+ * Generates code for recursive model index @p rmi with local absolute bounds, see #generate_code(). The bounds are
+ * interleaved with the layer2 models in the generated code regardless of the layout of @p rmi.
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Layer1, typename Layer2, typename Layout, typename Allocator>
+void generate(const RmiLAbs<std::uint64_t, Layer1, Layer2, Layout, Allocator> &rmi, const std::string &name,
+              std::ostream &header, std::ostream &source, const std::uint64_t build_time_ns = 0)
+{
+    auto description = std::string("rmi::RmiLAbs<") + model_code<Layer1>::name + ", " + model_code<Layer2>::name + ">";
+    auto errors = [&](std::size_t i) { return std::make_pair(rmi.error(i), rmi.error(i)); };
+    generate_code(rmi.layer1(), [&](std::size_t i) -> const Layer2 & { return rmi.layer2(i); }, errors,
+                  GeneratedBounds::local_abs, rmi.n_keys(), rmi.layer2_size(), description, name, build_time_ns,
+                  header, source);
+}
+
+/**
+ * Generates code for recursive model index @p rmi with local individual bounds, see #generate_code(). The bounds are
+ * interleaved with the layer2 models in the generated code regardless of the layout of @p rmi.
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param header stream to write the header to
+ * @param source stream to write the source to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Layer1, typename Layer2, typename Layout, typename Allocator>
+void generate(const RmiLInd<std::uint64_t, Layer1, Layer2, Layout, Allocator> &rmi, const std::string &name,
+              std::ostream &header, std::ostream &source, const std::uint64_t build_time_ns = 0)
+{
+    auto description = std::string("rmi::RmiLInd<") + model_code<Layer1>::name + ", " + model_code<Layer2>::name + ">";
+    auto errors = [&](std::size_t i) { return std::make_pair(rmi.error_lo(i), rmi.error_hi(i)); };
+    generate_code(rmi.layer1(), [&](std::size_t i) -> const Layer2 & { return rmi.layer2(i); }, errors,
+                  GeneratedBounds::local_ind, rmi.n_keys(), rmi.layer2_size(), description, name, build_time_ns,
+                  header, source);
+}
+
+/**
+ * Generates code for recursive model index @p rmi and writes it to the files `<name>.h` and `<name>.cpp` in
+ * @p directory, see #generate_code().
+ * @param rmi the index
+ * @param name the namespace of the generated index
+ * @param directory the directory to write the files to
+ * @param build_time_ns the build time of the index in nanoseconds
+ */
+template<typename Index>
+void generate(const Index &rmi, const std::string &name, const std::string &directory,
+              const std::uint64_t build_time_ns = 0)
+{
+    std::ofstream header(directory + '/' + name + ".h");
+    std::ofstream source(directory + '/' + name + ".cpp");
+    if (!header.is_open() or !source.is_open()) {
+        std::cerr << "Could not write " << directory << '/' << name << ".{h,cpp}." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    generate(rmi, name, header, source, build_time_ns);
+}
+
+} // namespace rmi
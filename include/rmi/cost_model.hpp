@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rmi/models.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Error Histogram
+ *====================================================================================================================*/
+
+/**
+ * Histogram of the prediction errors and search windows of lookups on an RMI. Values are counted in logarithmic
+ * buckets: bucket 0 holds the value 0 and bucket b > 0 holds the values in [2^(b-1), 2^b).
+ */
+struct ErrorHistogram
+{
+    std::vector<std::size_t> error;  ///< The number of lookups per bucket of the absolute prediction error.
+    std::vector<std::size_t> window; ///< The number of lookups per bucket of the size of the search window.
+    std::vector<std::size_t> side;   ///< The number of lookups per bucket of the size of the window side of the key.
+    std::size_t n_lookups = 0;       ///< The number of lookups.
+
+    /**
+     * Returns the bucket of value @p v.
+     * @param v the value
+     * @return the bucket of the value
+     */
+    static std::size_t bucket(const std::size_t v) { return v == 0 ? 0 : bit_width(v); }
+
+    /**
+     * Returns the value representing bucket @p b, i.e., the midpoint of its values.
+     * @param b the bucket
+     * @return the value representing the bucket
+     */
+    static double value(const std::size_t b) { return b == 0 ? 0. : 0.75 * std::ldexp(1., b) - 0.5; }
+
+    /**
+     * Adds a lookup of the key at position @p pos with position estimate @p pred and search window [lo, hi).
+     * Model-biased binary search only searches the side [lo, pred) or [pred, hi) of the window that contains the key.
+     * @param pred the position estimate
+     * @param pos the position of the key
+     * @param lo, hi the search window
+     */
+    void add(const std::size_t pred, const std::size_t pos, const std::size_t lo, const std::size_t hi) {
+        increment(error, bucket(pred > pos ? pred - pos : pos - pred));
+        increment(window, bucket(hi - lo));
+        increment(side, bucket(pos > pred ? hi - pred : pred - lo));
+        ++n_lookups;
+    }
+
+    private:
+    static void increment(std::vector<std::size_t> &counts, const std::size_t b) {
+        if (counts.size() <= b) counts.resize(b + 1, 0);
+        ++counts[b];
+    }
+};
+
+/**
+ * Computes the error histogram of looking up each of the sorted keys in [first, last) the @p index was built on. Keys
+ * occurring more than once are expected at their first occurrence. The search windows are the error bounds of the
+ * segments, so the histogram is obtained without performing the searches.
+ * @tparam Index the type of the index
+ * @param index the index
+ * @param first, last iterators that define the range of sorted keys the index was built on
+ * @return the error histogram
+ */
+template<typename Index, typename RandomIt>
+ErrorHistogram error_histogram(const Index &index, RandomIt first, RandomIt last)
+{
+    ErrorHistogram hist;
+    std::size_t n = std::distance(first, last);
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+        if (i == 0 or *(first + i) != *(first + i - 1)) pos = i; // first occurrence
+        auto range = index.search(*(first + i));
+        hist.add(range.pos, pos, range.lo, range.hi);
+    }
+    return hist;
+}
+
+
+/*======================================================================================================================
+ * Cost Model
+ *====================================================================================================================*/
+
+/**
+ * Type trait that identifies Radix models.
+ */
+template<typename Model>
+struct is_radix : std::false_type { };
+
+template<typename X>
+struct is_radix<Radix<X>> : std::true_type { };
+
+/**
+ * Per-machine costs of the steps of a lookup, used to predict the lookup time of RMI configurations. The costs of
+ * searches are tabulated per bucket of their size, i.e., the window size for binary search, the size of the searched
+ * side of the window for model-biased binary search, and the prediction error for model-biased exponential and
+ * linear search. Each table is measured on keys in the caches and on keys in DRAM.
+ *
+ * The default costs follow a simple analytic model of a current x86-64 server. The `rmi_calibrate` tool measures them
+ * on the target machine and writes a profile that is read by #load().
+ */
+struct CostModel
+{
+    double cache_ns = 4.;                ///< Latency of a random access that hits the last-level cache.
+    double dram_ns = 80.;                ///< Latency of a random access that misses the last-level cache.
+    std::size_t llc_bytes = 32ul << 20;  ///< Size of the last-level cache in bytes.
+    double linear_eval_ns = 1.;          ///< Time to evaluate a LinearSpline or LinearRegression.
+    double cubic_eval_ns = 2.;           ///< Time to evaluate a CubicSpline.
+    double radix_eval_ns = 1.;           ///< Time to evaluate a Radix model.
+    std::map<std::string, std::vector<double>> search_cached_ns; ///< Search time per bucket on cached keys.
+    std::map<std::string, std::vector<double>> search_dram_ns;   ///< Search time per bucket on keys in DRAM.
+
+    static constexpr const char *searches[] = {"binary", "model_biased_binary", "model_biased_exponential",
+                                               "model_biased_linear"}; ///< The searches whose costs are modeled.
+
+    /**
+     * Default constructor. Derives the search tables from the number of steps and of touched cache lines of each search
+     * on 64-bit keys, assuming 3 ns per step of binary and exponential search and 1 ns per step of linear search.
+     */
+    CostModel() {
+        auto fill = [](std::map<std::string, std::vector<double>> &tables, const double line_ns) {
+            for (std::size_t b = 0; b != 64; ++b) {
+                double v = ErrorHistogram::value(b);
+                double steps = std::log2(v + 1.);
+                double far_lines = std::log2(std::max(1., v / 8.)); // lines beyond the first touched by binary search
+                tables["binary"].push_back(steps * 3. + (1. + far_lines) * line_ns);
+                tables["model_biased_binary"].push_back((1. + steps) * 3. + (1. + far_lines) * line_ns);
+                tables["model_biased_exponential"].push_back((1. + 2. * steps) * 3. + (1. + 2. * far_lines) * line_ns);
+                tables["model_biased_linear"].push_back((1. + v) * 1. + (1. + v / 8.) * line_ns);
+            }
+        };
+        fill(search_cached_ns, cache_ns);
+        fill(search_dram_ns, dram_ns);
+    }
+
+    /**
+     * Returns the expected latency of a random access into @p bytes bytes of data, which are cached in proportion to
+     * the fraction of them that fits into the last-level cache.
+     * @param bytes the size of the accessed data
+     * @return expected access latency
+     */
+    double access_ns(const std::size_t bytes) const {
+        double hit_rate = std::min(1., static_cast<double>(llc_bytes) / std::max<std::size_t>(bytes, 1));
+        return hit_rate * cache_ns + (1. - hit_rate) * dram_ns;
+    }
+
+    /**
+     * Returns the time to evaluate a model of type @p Model, including models derived from the basic model types.
+     * @tparam Model the model type
+     * @return evaluation time
+     */
+    template<typename Model>
+    double eval_ns() const {
+        if constexpr (std::is_base_of<CubicSpline, Model>::value) return cubic_eval_ns;
+        else if constexpr (is_radix<Model>::value) return radix_eval_ns;
+        else return linear_eval_ns;
+    }
+
+    /**
+     * Returns the expected time of @p search for the lookups of @p hist on @p bytes bytes of keys and index, which are
+     * cached in proportion to the fraction of them that fits into the last-level cache. Tables are extrapolated beyond
+     * their largest bucket, logarithmically for binary and exponential search and linearly for linear search.
+     * @param search the name of the search algorithm, one of #searches
+     * @param hist the error histogram of the lookups
+     * @param bytes the size of keys and index in bytes
+     * @return expected search time
+     */
+    double search_ns(const std::string &search, const ErrorHistogram &hist, const std::size_t bytes) const {
+        auto cached = search_cached_ns.find(search);
+        auto dram = search_dram_ns.find(search);
+        if (cached == search_cached_ns.end() or dram == search_dram_ns.end()) {
+            std::cerr << "Error: No costs for search " << search << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        const bool is_linear = search == "model_biased_linear";
+        auto cost = [&](const std::vector<double> &table, const std::size_t b) {
+            std::size_t last = table.size() - 1;
+            if (b <= last or last == 0) return table[std::min(b, last)];
+            if (is_linear) return table[last] * (ErrorHistogram::value(b) + 1.) / (ErrorHistogram::value(last) + 1.);
+            return table[last] + (b - last) * (table[last] - table[last - 1]);
+        };
+        auto &counts = search == "binary" ? hist.window : search == "model_biased_binary" ? hist.side : hist.error;
+        double hit_rate = std::min(1., static_cast<double>(llc_bytes) / std::max<std::size_t>(bytes, 1));
+        double ns = 0.;
+        for (std::size_t b = 0; b != counts.size(); ++b)
+            ns += counts[b] * (hit_rate * cost(cached->second, b) + (1. - hit_rate) * cost(dram->second, b));
+        return ns / hist.n_lookups;
+    }
+
+    /**
+     * Writes the cost model to the csv file @p filename with columns parameter, bucket, and value. Search tables are
+     * written as parameters `<search>_cached` and `<search>_dram` with one row per bucket.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        std::ofstream out(filename);
+        if (not out.is_open()) {
+            std::cerr << "Could not write " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        out.precision(6);
+        out << "parameter,bucket,value\n"
+            << "cache_ns,0," << cache_ns << '\n'
+            << "dram_ns,0," << dram_ns << '\n'
+            << "llc_bytes,0," << llc_bytes << '\n'
+            << "linear_eval_ns,0," << linear_eval_ns << '\n'
+            << "cubic_eval_ns,0," << cubic_eval_ns << '\n'
+            << "radix_eval_ns,0," << radix_eval_ns << '\n';
+        for (auto &[search, table] : search_cached_ns)
+            for (std::size_t b = 0; b != table.size(); ++b) out << search << "_cached," << b << ',' << table[b] << '\n';
+        for (auto &[search, table] : search_dram_ns)
+            for (std::size_t b = 0; b != table.size(); ++b) out << search << "_dram," << b << ',' << table[b] << '\n';
+    }
+
+    /**
+     * Reads a cost model from the csv file @p filename written by #save(). Parameters missing from the file keep their
+     * default values, search tables in the file replace the default tables.
+     * @param filename name of the file to read from
+     * @return the cost model
+     */
+    static CostModel load(const std::string &filename) {
+        std::ifstream in(filename);
+        if (not in.is_open()) {
+            std::cerr << "Could not load " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        CostModel cost;
+        std::map<std::string, double*> scalars = {
+            { "cache_ns", &cost.cache_ns }, { "dram_ns", &cost.dram_ns }, { "linear_eval_ns", &cost.linear_eval_ns },
+            { "cubic_eval_ns", &cost.cubic_eval_ns }, { "radix_eval_ns", &cost.radix_eval_ns },
+        };
+        std::map<std::string, std::vector<double>> cached, dram;
+        std::string line;
+        std::getline(in, line); // skip header
+        while (std::getline(in, line)) {
+            auto fields = split(line, ',');
+            if (fields.size() != 3) continue;
+            const std::string &parameter = fields[0];
+            std::size_t b = std::stoul(fields[1]);
+            double value = std::stod(fields[2]);
+            auto set = [&](std::vector<double> &table) {
+                if (table.size() <= b) table.resize(b + 1, 0.);
+                table[b] = value;
+            };
+            auto suffix = [&](const std::string &s) {
+                return parameter.size() > s.size() and parameter.compare(parameter.size() - s.size(), s.size(), s) == 0;
+            };
+            if (parameter == "llc_bytes") cost.llc_bytes = static_cast<std::size_t>(value);
+            else if (scalars.count(parameter)) *scalars[parameter] = value;
+            else if (suffix("_cached")) set(cached[parameter.substr(0, parameter.size() - 7)]);
+            else if (suffix("_dram")) set(dram[parameter.substr(0, parameter.size() - 5)]);
+            else {
+                std::cerr << "Error: Unknown parameter " << parameter << " in " << filename << '.' << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        for (auto &[search, table] : cached) cost.search_cached_ns[search] = table;
+        for (auto &[search, table] : dram) cost.search_dram_ns[search] = table;
+        return cost;
+    }
+};
+
+/**
+ * Predicts the lookup time of an RMI with @p Layer1 and @p Layer2 models, @p bounds, and @p search from the per-machine
+ * @p cost model and the error histogram @p hist of the lookups, without performing them. A lookup evaluates both
+ * models, accesses its layer2 model and, for local bounds, its error bounds, which happens in parallel, and searches
+ * the keys.
+ * @tparam Layer1 the type of the model used in layer1
+ * @tparam Layer2 the type of the models used in layer2
+ * @param cost the cost model
+ * @param hist the error histogram of the lookups, e.g., computed by #error_histogram()
+ * @param bounds the type of error bounds, either none, labs, lind, gabs, or gind
+ * @param search the name of the search algorithm, one of CostModel::searches
+ * @param index_bytes the size of the index in bytes
+ * @param keys_bytes the size of the keys in bytes
+ * @return predicted lookup time in nanoseconds
+ */
+template<typename Layer1, typename Layer2>
+double predict_lookup_ns(const CostModel &cost, const ErrorHistogram &hist, const std::string &bounds,
+                         const std::string &search, const std::size_t index_bytes, const std::size_t keys_bytes)
+{
+    bool has_local_bounds = bounds == "labs" or bounds == "lind";
+    return cost.eval_ns<Layer1>() + cost.eval_ns<Layer2>() + cost.access_ns(index_bytes) +
+           (has_local_bounds ? cost.cache_ns : 0.) + cost.search_ns(search, hist, keys_bytes + index_bytes);
+}
+
+} // namespace rmi
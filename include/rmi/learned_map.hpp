@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+
+
+namespace rmi {
+
+/**
+ * A read-only sorted map from keys to payloads that owns its keys, its payloads, and a recursive model index built on
+ * the keys. Keys and payloads are stored as a struct of arrays, so that the last-mile search only touches keys. A
+ * lookup returns an iterator to both the key and its payload.
+ *
+ * Since the map knows the predicted position of a key before the last-mile search, it prefetches the payload at the
+ * predicted position, which overlaps the payload access with the search for most lookups.
+ *
+ * Duplicate keys are supported. Lookups of keys that are not in the map return correct results even if the index
+ * places them outside its search bounds.
+ *
+ * @tparam Key the type of the keys
+ * @tparam Value the type of the payloads
+ * @tparam Rmi the type of the index built on the keys, e.g., `RmiLAbs<Key, LinearSpline, LinearRegression>`
+ * @tparam Search the type of the search correcting prediction errors, e.g., BinarySearch
+ */
+template<typename Key, typename Value, typename Rmi, typename Search>
+class LearnedMap
+{
+    using key_type = Key;
+    using mapped_type = Value;
+    using rmi_type = Rmi;
+    using search_type = Search;
+
+    protected:
+    std::vector<key_type> keys_;      ///< The sorted keys.
+    std::vector<mapped_type> values_; ///< The payloads, values_[i] belongs to keys_[i].
+    rmi_type rmi_;                    ///< The index built on the keys.
+
+    public:
+    /**
+     * Random-access iterator over the key-payload pairs of the map. Dereferencing yields a pair of references to the
+     * key and the payload.
+     */
+    class const_iterator
+    {
+        friend class LearnedMap;
+
+        private:
+        const LearnedMap *map_ = nullptr; ///< The map iterated over.
+        std::ptrdiff_t i_ = 0;            ///< The position of the current pair.
+
+        const_iterator(const LearnedMap *map, const std::ptrdiff_t i) : map_(map), i_(i) { }
+
+        public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<key_type, mapped_type>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const key_type&, const mapped_type&>;
+
+        /**
+         * Pointer-like wrapper of a reference to support `it->first` and `it->second`.
+         */
+        struct pointer {
+            reference ref;
+            const reference * operator->() const { return &ref; }
+        };
+
+        const_iterator() = default;
+
+        reference operator*() const { return {map_->keys_[i_], map_->values_[i_]}; }
+        pointer operator->() const { return {**this}; }
+        reference operator[](const difference_type n) const { return *(*this + n); }
+
+        /**
+         * Returns the key of the current pair.
+         * @return the key
+         */
+        const key_type & key() const { return map_->keys_[i_]; }
+
+        /**
+         * Returns the payload of the current pair.
+         * @return the payload
+         */
+        const mapped_type & value() const { return map_->values_[i_]; }
+
+        const_iterator & operator++() { ++i_; return *this; }
+        const_iterator & operator--() { --i_; return *this; }
+        const_iterator operator++(int) { auto tmp = *this; ++i_; return tmp; }
+        const_iterator operator--(int) { auto tmp = *this; --i_; return tmp; }
+        const_iterator & operator+=(const difference_type n) { i_ += n; return *this; }
+        const_iterator & operator-=(const difference_type n) { i_ -= n; return *this; }
+        const_iterator operator+(const difference_type n) const { return {map_, i_ + n}; }
+        const_iterator operator-(const difference_type n) const { return {map_, i_ - n}; }
+        friend const_iterator operator+(const difference_type n, const const_iterator &it) { return it + n; }
+        difference_type operator-(const const_iterator &other) const { return i_ - other.i_; }
+
+        bool operator==(const const_iterator &other) const { return i_ == other.i_; }
+        bool operator!=(const const_iterator &other) const { return i_ != other.i_; }
+        bool operator<(const const_iterator &other) const { return i_ < other.i_; }
+        bool operator>(const const_iterator &other) const { return i_ > other.i_; }
+        bool operator<=(const const_iterator &other) const { return i_ <= other.i_; }
+        bool operator>=(const const_iterator &other) const { return i_ >= other.i_; }
+    };
+
+    /**
+     * Default constructor.
+     */
+    LearnedMap() = default;
+
+    /**
+     * Builds the map on sorted @p keys and their @p values with @p layer2_size models in layer2 of the index.
+     * @param keys vector of sorted keys
+     * @param values vector of payloads, the i-th payload belongs to the i-th key
+     * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for building the index
+     */
+    LearnedMap(std::vector<key_type> keys, std::vector<mapped_type> values, const std::size_t layer2_size,
+               const std::size_t n_threads = 1)
+        : keys_(std::move(keys))
+        , values_(std::move(values))
+        , rmi_(keys_, layer2_size, n_threads)
+    {
+        if (keys_.size() != values_.size()) {
+            std::cerr << "Error: " << keys_.size() << " keys but " << values_.size() << " payloads." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /**
+     * Builds the map on the key-payload pairs in the range [first, last) with @p layer2_size models in layer2 of the
+     * index. The pairs need not be sorted. Pairs with equal keys keep their relative order.
+     * @param first, last iterators that define the range of key-payload pairs
+     * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for building the index
+     */
+    template<typename InputIt>
+    LearnedMap(InputIt first, InputIt last, const std::size_t layer2_size, const std::size_t n_threads = 1)
+        : LearnedMap(split(std::vector<std::pair<key_type, mapped_type>>(first, last)), layer2_size, n_threads) { }
+
+    LearnedMap(LearnedMap&&) = default;
+    LearnedMap & operator=(LearnedMap&&) = default;
+
+    /**
+     * Returns an iterator to the first pair whose key is not less than @p key.
+     * @param key to search for
+     * @return iterator to the first pair whose key is not less than @p key, or end() if there is none
+     */
+    const_iterator lower_bound(const key_type key) const {
+        return const_iterator(this, find_pos(key));
+    }
+
+    /**
+     * Returns an iterator to the first pair with key @p key.
+     * @param key to search for
+     * @return iterator to the first pair with key @p key, or end() if there is none
+     */
+    const_iterator find(const key_type key) const {
+        std::size_t pos = search_pos(key);
+        return pos != keys_.size() and keys_[pos] == key ? const_iterator(this, pos) : end();
+    }
+
+    /**
+     * Returns whether the map contains a pair with key @p key.
+     * @param key to search for
+     * @return whether the map contains @p key
+     */
+    bool contains(const key_type key) const {
+        std::size_t pos = search_pos(key);
+        return pos != keys_.size() and keys_[pos] == key;
+    }
+
+    /**
+     * Returns the range of pairs with key @p key. Duplicates following the first match are found by exponential search.
+     * @param key to search for
+     * @return the range of pairs with key @p key, which is empty if there is none
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const key_type key) const {
+        std::size_t pos = search_pos(key);
+        std::size_t n = keys_.size();
+        if (pos == n or keys_[pos] != key) { // not contained, return empty range at lower bound
+            auto it = lower_bound(key);
+            return {it, it};
+        }
+        std::size_t lo = pos;
+        std::size_t hi = pos;
+        std::size_t bound = 1;
+        while (hi < n and keys_[hi] == key) { // gallop over duplicates
+            lo = hi;
+            hi += bound;
+            bound *= 2;
+        }
+        hi = std::upper_bound(keys_.begin() + lo, keys_.begin() + std::min(hi, n), key) - keys_.begin();
+        return {const_iterator(this, pos), const_iterator(this, hi)};
+    }
+
+    /**
+     * Returns the range of pairs whose keys lie in [@p lo_key, @p hi_key). The range is empty if @p hi_key is not
+     * greater than @p lo_key.
+     *
+     * Both endpoints are located by the index. If the search window of @p hi_key overlaps the position found for
+     * @p lo_key, which is the common case for short ranges whose endpoints predict into the same or adjacent segments,
+     * the search for @p hi_key is narrowed to the part of its window right of that position.
+     * @param lo_key the smallest key of the range
+     * @param hi_key the key past the range
+     * @return the range of pairs whose keys lie in [@p lo_key, @p hi_key)
+     */
+    std::pair<const_iterator, const_iterator> range(const key_type lo_key, const key_type hi_key) const {
+        auto [first, last] = range_pos(lo_key, hi_key);
+        return {const_iterator(this, first), const_iterator(this, last)};
+    }
+
+    /**
+     * Returns the number of pairs whose keys lie in [@p lo_key, @p hi_key).
+     * @param lo_key the smallest key of the range
+     * @param hi_key the key past the range
+     * @return the number of pairs whose keys lie in [@p lo_key, @p hi_key)
+     */
+    std::size_t range_count(const key_type lo_key, const key_type hi_key) const {
+        auto [first, last] = range_pos(lo_key, hi_key);
+        return last - first;
+    }
+
+    /**
+     * Returns an iterator to the first pair.
+     * @return iterator to the first pair
+     */
+    const_iterator begin() const { return {this, 0}; }
+
+    /**
+     * Returns an iterator past the last pair.
+     * @return iterator past the last pair
+     */
+    const_iterator end() const { return {this, static_cast<std::ptrdiff_t>(keys_.size())}; }
+
+    /**
+     * Returns the number of pairs in the map.
+     * @return the number of pairs
+     */
+    std::size_t size() const { return keys_.size(); }
+
+    /**
+     * Returns whether the map is empty.
+     * @return whether the map is empty
+     */
+    bool empty() const { return keys_.empty(); }
+
+    /**
+     * Returns the sorted keys.
+     * @return the keys
+     */
+    const std::vector<key_type> & keys() const { return keys_; }
+
+    /**
+     * Returns the payloads in the order of the keys.
+     * @return the payloads
+     */
+    const std::vector<mapped_type> & values() const { return values_; }
+
+    /**
+     * Returns the index built on the keys.
+     * @return the index
+     */
+    const rmi_type & index() const { return rmi_; }
+
+    /**
+     * Returns the size of the index in bytes, excluding keys and payloads.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return rmi_.size_in_bytes(); }
+
+    private:
+    /**
+     * Builds the map on sorted keys and payloads that were split from pairs.
+     * @param columns the sorted keys and their payloads
+     * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for building the index
+     */
+    LearnedMap(std::pair<std::vector<key_type>, std::vector<mapped_type>> columns, const std::size_t layer2_size,
+               const std::size_t n_threads)
+        : LearnedMap(std::move(columns.first), std::move(columns.second), layer2_size, n_threads) { }
+
+    /**
+     * Sorts key-payload pairs by key and splits them into a vector of keys and a vector of payloads.
+     * @param pairs the key-payload pairs
+     * @return the sorted keys and their payloads
+     */
+    static std::pair<std::vector<key_type>, std::vector<mapped_type>>
+    split(std::vector<std::pair<key_type, mapped_type>> pairs) {
+        std::stable_sort(pairs.begin(), pairs.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+        std::pair<std::vector<key_type>, std::vector<mapped_type>> columns;
+        columns.first.reserve(pairs.size());
+        columns.second.reserve(pairs.size());
+        for (auto &p : pairs) {
+            columns.first.push_back(p.first);
+            columns.second.push_back(std::move(p.second));
+        }
+        return columns;
+    }
+
+    /**
+     * Returns the position of the first key within the search bounds of the index that is not less than @p key. If
+     * the map contains @p key, this is the position of its first occurrence, since the error bounds cover the first
+     * occurrence of every indexed key. The payload at the predicted position is prefetched before the last-mile search.
+     * @param key to search for
+     * @return the position of the first key within the search bounds that is not less than @p key
+     */
+    std::size_t search_pos(const key_type key) const {
+        if (keys_.empty()) return 0;
+        auto range = rmi_.search(key);
+        __builtin_prefetch(values_.data() + range.pos);
+        auto first = keys_.begin();
+        return search_type()(first + range.lo, first + range.hi, first + range.pos, key) - first;
+    }
+
+    /**
+     * Returns the position of the first key that is not less than @p key. Keys that are not contained in the map may
+     * lie outside the search bounds of the index, in which case the search continues on the respective side of the
+     * bounds.
+     * @param key to search for
+     * @return the position of the first key that is not less than @p key
+     */
+    std::size_t find_pos(const key_type key) const {
+        if (keys_.empty()) return 0;
+        return find_pos(key, rmi_.search(key));
+    }
+
+    /**
+     * Returns the position of the first key that is not less than @p key, starting from the search bounds @p range.
+     * @param key to search for
+     * @param range position estimate and search bounds of @p key
+     * @return the position of the first key that is not less than @p key
+     */
+    std::size_t find_pos(const key_type key, const Approx range) const {
+        auto first = keys_.begin();
+        std::size_t pos = search_type()(first + range.lo, first + range.hi, first + range.pos, key) - first;
+        if (pos == range.lo and pos != 0 and keys_[pos - 1] >= key)
+            pos = std::lower_bound(first, first + pos, key) - first; // continue left of the bounds
+        else if (pos == range.hi and pos != keys_.size() and keys_[pos] < key)
+            pos = std::lower_bound(first + pos, keys_.end(), key) - first; // continue right of the bounds
+        return pos;
+    }
+
+    /**
+     * Returns the positions of the first key that is not less than @p lo_key and of the first key that is not less
+     * than @p hi_key. All keys left of the first position are less than @p lo_key and thus less than @p hi_key, so the
+     * search window of @p hi_key is cut at the first position, and the second search only covers what remains of it.
+     * @param lo_key the smallest key of the range
+     * @param hi_key the key past the range
+     * @return the positions delimiting the range
+     */
+    std::pair<std::size_t, std::size_t> range_pos(const key_type lo_key, const key_type hi_key) const {
+        if (keys_.empty()) return {0, 0};
+        auto lo_range = rmi_.search(lo_key);
+        auto hi_range = rmi_.search(hi_key);
+        std::size_t first = find_pos(lo_key, lo_range);
+        if (not (lo_key < hi_key) or first == keys_.size()) return {first, first}; // empty or past the last key
+        if (first >= hi_range.lo) { // shared window, continue right of the first position
+            hi_range.lo = first;
+            hi_range.hi = std::max(hi_range.hi, first);
+            // Keep the estimate inside a non-empty window since searches dereference it.
+            hi_range.pos = hi_range.hi > hi_range.lo ? std::clamp(hi_range.pos, hi_range.lo, hi_range.hi - 1)
+                                                     : hi_range.lo;
+        }
+        return {first, find_pos(hi_key, hi_range)};
+    }
+};
+
+} // namespace rmi
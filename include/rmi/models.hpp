@@ -1,22 +1,53 @@
 #pragma once
 
 #include <cmath>
+#include <iterator>
 #include <x86intrin.h>
 
 #include "rmi/util/fn.hpp"
+#include "rmi/util/key_traits.hpp"
 
 namespace rmi {
 
+/**
+ * Iterator over consecutive positions that is used to hand y-values implicitly to models.
+ */
+class counting_iterator
+{
+    private:
+    std::size_t i_; ///< The current position.
+
+    public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::size_t;
+
+    explicit counting_iterator(const std::size_t i) : i_(i) { }
+
+    std::size_t operator*() const { return i_; }
+    counting_iterator & operator++() { ++i_; return *this; }
+    counting_iterator operator+(const difference_type n) const { return counting_iterator(i_ + n); }
+    counting_iterator operator-(const difference_type n) const { return counting_iterator(i_ - n); }
+    difference_type operator-(const counting_iterator &other) const { return i_ - other.i_; }
+    bool operator==(const counting_iterator &other) const { return i_ == other.i_; }
+    bool operator!=(const counting_iterator &other) const { return i_ != other.i_; }
+};
+
+
 /**
  * A model that fits a linear segment from the first first to the last data point.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
- * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
- * providing a @p compression_factor.
+ * offset + distance(first, last) are the first and last y-value, respectively. Alternatively, ascending y-values can
+ * be handed explicitly, e.g., the positions of the first occurrences of duplicate x-values. The y-values can be scaled
+ * by providing a @p compression_factor.
  */
 class LinearSpline
 {
     private:
+    // The batched SIMD evaluation in `rmi/util/simd.hpp` gathers #slope_ and #intercept_ in this order.
     double slope_;     ///< The slope of the linear segment.
     double intercept_; ///< The y-intercept of the lienar segment.
 
@@ -33,7 +64,18 @@ class LinearSpline
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    LinearSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    LinearSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : LinearSpline(first, last, counting_iterator(offset), counting_iterator(offset + std::distance(first, last)),
+                       compression_factor) { }
+
+    /**
+     * Builds a linear segment between the first and last data point with explicit y-values.
+     * @param first, last iterators to the first and last x-value the linear segment is fit on
+     * @param y_first, y_last iterators to the first and last y-value the linear segment is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    LinearSpline(RandomIt first, RandomIt last, YIt y_first, YIt y_last, double compression_factor) {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
@@ -41,14 +83,15 @@ class LinearSpline
             intercept_ = 0.f;
             return;
         }
+        std::size_t offset = *y_first;
         if (n == 1) {
             slope_ = 0.f;
             intercept_ = static_cast<double>(offset) * compression_factor;
             return;
         }
 
-        double numerator = static_cast<double>(n); // (offset + n) - offset
-        double denominator = static_cast<double>(*(last - 1) - *first);
+        double numerator = static_cast<double>(*(y_last - 1) + 1 - offset); // (offset + n) - offset
+        double denominator = key_delta(*first, *(last - 1));
 
         slope_ = denominator != 0.0 ? numerator/denominator * compression_factor : 0.0;
         intercept_ = offset * compression_factor - slope_ * *first;
@@ -96,12 +139,14 @@ class LinearSpline
  * A linear regression model that fits a straight line to minimize the mean squared error.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
- * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
- * providing a @p compression_factor.
+ * offset + distance(first, last) are the first and last y-value, respectively. Alternatively, ascending y-values can
+ * be handed explicitly, e.g., the positions of the first occurrences of duplicate x-values. The y-values can be scaled
+ * by providing a @p compression_factor.
  */
 class LinearRegression
 {
     private:
+    // The batched SIMD evaluation in `rmi/util/simd.hpp` gathers #slope_ and #intercept_ in this order.
     double slope_;     ///< The slope of the linear function.
     double intercept_; ///< The y-intercept of the lienar function.
 
@@ -118,7 +163,18 @@ class LinearRegression
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    LinearRegression(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    LinearRegression(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : LinearRegression(first, last, counting_iterator(offset),
+                           counting_iterator(offset + std::distance(first, last)), compression_factor) { }
+
+    /**
+     * Builds a linear regression model on the given data points with explicit y-values.
+     * @param first, last iterators to the first and last x-value the linear regression is fit on
+     * @param y_first, y_last iterators to the first and last y-value the linear regression is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    LinearRegression(RandomIt first, RandomIt last, YIt y_first, YIt /* y_last */, double compression_factor) {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
@@ -128,7 +184,7 @@ class LinearRegression
         }
         if (n == 1) {
             slope_ = 0.f;
-            intercept_ = static_cast<double>(offset) * compression_factor;
+            intercept_ = static_cast<double>(*y_first) * compression_factor;
             return;
         }
 
@@ -139,7 +195,7 @@ class LinearRegression
 
         for (std::size_t i = 0; i != n; ++i) {
             auto x = *(first + i);
-            std::size_t y = offset + i;
+            std::size_t y = *(y_first + i);
 
             double dx = x - mean_x;
             mean_x += dx /  (i + 1);
@@ -205,8 +261,9 @@ class LinearRegression
  * A model that fits a cubic segment from the first first to the last data point.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
- * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
- * providing a @p compression_factor.
+ * offset + distance(first, last) are the first and last y-value, respectively. Alternatively, ascending y-values can
+ * be handed explicitly, e.g., the positions of the first occurrences of duplicate x-values. The y-values can be scaled
+ * by providing a @p compression_factor.
  */
 class CubicSpline
 {
@@ -229,7 +286,18 @@ class CubicSpline
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    CubicSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    CubicSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : CubicSpline(first, last, counting_iterator(offset), counting_iterator(offset + std::distance(first, last)),
+                      compression_factor) { }
+
+    /**
+     * Builds a cubic segment between the first and last data point with explicit y-values.
+     * @param first, last iterators to the first and last x-value the cubic segment is fit on
+     * @param y_first, y_last iterators to the first and last y-value the cubic segment is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    CubicSpline(RandomIt first, RandomIt last, YIt y_first, YIt y_last, double compression_factor) {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
@@ -243,14 +311,14 @@ class CubicSpline
             a_ = 0.f;
             b_ = 0.f;
             c_ = 0.f;
-            d_ = static_cast<double>(offset) * compression_factor;
+            d_ = static_cast<double>(*y_first) * compression_factor;
             return;
         }
 
         double xmin = static_cast<double>(*first);
-        double ymin = static_cast<double>(offset) * compression_factor;
+        double ymin = static_cast<double>(*y_first) * compression_factor;
         double xmax = static_cast<double>(*(last - 1));
-        double ymax = static_cast<double>(offset + n - 1) * compression_factor;
+        double ymax = static_cast<double>(*(y_last - 1)) * compression_factor;
 
         double x1 = 0.0;
         double y1 = 0.0;
@@ -260,7 +328,7 @@ class CubicSpline
         double sxn, syn = 0.0;
         for (std::size_t i = 0; i != n; ++i) {
             double x = static_cast<double>(*(first + i));
-            double y = static_cast<double>(offset + i) * compression_factor;
+            double y = static_cast<double>(*(y_first + i)) * compression_factor;
             sxn = (x - xmin) / (xmax - xmin);
             if (sxn > 0.0) {
                 syn = (y - ymin) / (ymax - ymin);
@@ -272,7 +340,7 @@ class CubicSpline
         double sxp, syp = 0.0;
         for (std::size_t i = 0; i != n; ++i) {
             double x = static_cast<double>(*(first + i));
-            double y = static_cast<double>(offset + i) * compression_factor;
+            double y = static_cast<double>(*(y_first + i)) * compression_factor;
             sxp = (x - xmin) / (xmax - xmin);
             if (sxp < 1.0) {
                 syp = (y - ymin) / (ymax - ymin);
@@ -386,8 +454,13 @@ class CubicSpline
  * A radix model that projects a x-values to their most significant bits after eliminating the common prefix.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
- * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
- * providing a @p compression_factor.
+ * offset + distance(first, last) are the first and last y-value, respectively. Alternatively, ascending y-values can
+ * be handed explicitly, e.g., the positions of the first occurrences of duplicate x-values. The y-values can be scaled
+ * by providing a @p compression_factor.
+ *
+ * The bits are taken from the order-preserving encoding of the x-values, see key_traits, so that signed integers and
+ * floating-point numbers are supported. Up to 64 bits, bits are extracted by `_pext`. Since the mask is contiguous,
+ * 128-bit values are masked and shifted instead.
  *
  * @tparam the type of x-values.
  */
@@ -395,9 +468,10 @@ template<typename X = uint64_t>
 class Radix
 {
     using x_type = X;
+    using bits_type = typename key_traits<X>::encoded_type;
 
     private:
-    x_type mask_; ///< The mask for parallel bits extract.
+    bits_type mask_; ///< The mask for parallel bits extract.
 
     public:
     /*
@@ -412,7 +486,18 @@ class Radix
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    Radix(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    Radix(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : Radix(first, last, counting_iterator(offset), counting_iterator(offset + std::distance(first, last)),
+                compression_factor) { }
+
+    /**
+     * Builds a radix model on the given data points with explicit y-values.
+     * @param first, last iterators to the first and last x-value the radix model is fit on
+     * @param y_first, y_last iterators to the first and last y-value the radix model is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    Radix(RandomIt first, RandomIt last, YIt /* y_first */, YIt y_last, double compression_factor) {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
@@ -420,7 +505,8 @@ class Radix
             return;
         }
 
-        auto prefix = common_prefix_width(*first, *(last - 1)); // compute common prefix length
+        // Compute common prefix length.
+        auto prefix = common_prefix_width(key_traits<X>::encode(*first), key_traits<X>::encode(*(last - 1)));
 
         if (prefix == (sizeof(x_type) * 8)) {
             mask_ = 42; // TODO: What should the mask be in this case?
@@ -428,12 +514,12 @@ class Radix
         }
 
         // Determine radix width.
-        std::size_t max = static_cast<std::size_t>(offset + n - 1) * compression_factor;
+        std::size_t max = static_cast<std::size_t>(*(y_last - 1)) * compression_factor;
         bool is_mersenne = (max & (max + 1)) == 0; // check if max is 2^n-1
         auto radix = is_mersenne ? bit_width<std::size_t>(max) : bit_width<std::size_t>(max) - 1;
 
         // Mask all bits but the radix
-        mask_ = (~(x_type)0 >> prefix) & (~(x_type)0 << ((sizeof(x_type) * 8) - radix - prefix)); //0xffff << prefix_
+        mask_ = (~(bits_type)0 >> prefix) & (~(bits_type)0 << ((sizeof(x_type) * 8) - radix - prefix));
     }
 
     /**
@@ -443,12 +529,18 @@ class Radix
      */
     // double predict(const x_type x) const { return (x << prefix_) >> ((sizeof(x_type) * 8) - radix_); }
     double predict(const x_type x) const {
+        bits_type bits = key_traits<X>::encode(x);
         if constexpr(sizeof(x_type) <= sizeof(unsigned)) {
-            return _pext_u32(x, mask_);
+            return _pext_u32(bits, mask_);
         } else if constexpr(sizeof(x_type) <= sizeof(unsigned long long)) {
-            return _pext_u64(x, mask_);
+            return _pext_u64(bits, mask_);
+        } else if constexpr(sizeof(x_type) == 2 * sizeof(unsigned long long)) {
+            auto lo = static_cast<unsigned long long>(mask_);
+            auto hi = static_cast<unsigned long long>(mask_ >> 64);
+            int shift = lo != 0 ? __builtin_ctzll(lo) : (hi != 0 ? 64 + __builtin_ctzll(hi) : 0);
+            return static_cast<double>((bits & mask_) >> shift);
         } else {
-            static_assert(sizeof(x_type) > sizeof(unsigned long long), "unsupported width of integral type");
+            static_assert(sizeof(x_type) > 2 * sizeof(unsigned long long), "unsupported width of integral type");
         }
     }
 
@@ -456,7 +548,7 @@ class Radix
      * Returns the mask used for parallel bits extraction.
      * @return the mask
      */
-    uint8_t mask() const { return mask_; }
+    bits_type mask() const { return mask_; }
 
     /**
      * Returns the size of the radix model in bytes.
@@ -475,4 +567,252 @@ class Radix
     }
 };
 
+
+/**
+ * An adapter that fits a model on the distances of the x-values to the first x-value, its base, instead of on the
+ * x-values themselves.
+ *
+ * Models convert x-values to `double`, which only represents integers up to 2^53 exactly. For larger x-values, e.g.,
+ * 64-bit keys with a common high part or 128-bit composite keys, close x-values become indistinguishable and
+ * predictions degrade. The distances within a segment are small, so they are computed exactly by key_delta() before
+ * being converted.
+ *
+ * @tparam Model the type of the model fit on the distances, e.g., LinearRegression
+ * @tparam X the type of x-values
+ */
+template<typename Model, typename X = uint64_t>
+class Centered
+{
+    using x_type = X;
+
+    private:
+    /**
+     * Iterator over the distances of the x-values to the base.
+     */
+    template<typename RandomIt>
+    class delta_iterator
+    {
+        private:
+        RandomIt it_;  ///< The iterator to the x-value.
+        x_type base_;  ///< The base.
+
+        public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = double;
+        using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+        using pointer = void;
+        using reference = double;
+
+        delta_iterator(RandomIt it, x_type base) : it_(it), base_(base) { }
+
+        double operator*() const { return key_delta(base_, static_cast<x_type>(*it_)); }
+        delta_iterator & operator++() { ++it_; return *this; }
+        delta_iterator operator+(difference_type n) const { return {it_ + n, base_}; }
+        delta_iterator operator-(difference_type n) const { return {it_ - n, base_}; }
+        difference_type operator-(const delta_iterator &other) const { return it_ - other.it_; }
+        bool operator==(const delta_iterator &other) const { return it_ == other.it_; }
+        bool operator!=(const delta_iterator &other) const { return it_ != other.it_; }
+    };
+
+    x_type base_; ///< The x-value the distances are computed to.
+    Model model_; ///< The model fit on the distances.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    Centered() = default;
+
+    /**
+     * Builds the model on the distances of the given x-values to the first x-value.
+     * @param first, last iterators to the first and last x-value the model is fit on
+     * @param offset first y-value the model is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    Centered(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : base_(first != last ? static_cast<x_type>(*first) : x_type())
+        , model_(delta_iterator<RandomIt>(first, base_), delta_iterator<RandomIt>(last, base_), offset,
+                 compression_factor) { }
+
+    /**
+     * Builds the model on the distances of the given x-values to the first x-value with explicit y-values.
+     * @param first, last iterators to the first and last x-value the model is fit on
+     * @param y_first, y_last iterators to the first and last y-value the model is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    Centered(RandomIt first, RandomIt last, YIt y_first, YIt y_last, double compression_factor)
+        : base_(first != last ? static_cast<x_type>(*first) : x_type())
+        , model_(delta_iterator<RandomIt>(first, base_), delta_iterator<RandomIt>(last, base_), y_first, y_last,
+                 compression_factor) { }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    double predict(const x_type x) const { return model_.predict(key_delta(base_, x)); }
+
+    /**
+     * Returns the base the distances are computed to.
+     * @return the base
+     */
+    x_type base() const { return base_; }
+
+    /**
+     * Returns the model fit on the distances.
+     * @return the model
+     */
+    const Model & model() const { return model_; }
+
+    /**
+     * Returns the size of the model and its base in bytes.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() { return sizeof(base_) + model_.size_in_bytes(); }
+
+    /**
+     * Writes the mathematical representation of the model to an output stream.
+     * @param out output stream to write the model to
+     * @param m the model
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const Centered &m) {
+        return out << m.model() << " with x := x - " << static_cast<double>(m.base());
+    }
+};
+
+
+/**
+ * An integer-only model that evaluates a linear model, e.g., LinearSpline or LinearRegression, in fixed-point
+ * arithmetic.
+ *
+ * Linear models convert x-values to `double` and the index converts their predictions back to integer positions, which
+ * puts several int-float conversions on the critical path of each lookup. Instead, the model is fit on the distances
+ * of the x-values to the first x-value, its base, like by Centered, and its slope and intercept are then rounded to a
+ * fixed-point slope with a 64-bit mantissa and an integer intercept. A prediction is
+ * `intercept + ((x - base) << shift_left) * m >> (64 + shift_right)`, where only one of the shifts is non-zero, and
+ * the index clamps it to the valid range of positions in integers.
+ *
+ * Predictions are monotonic in x like those of the underlying model, i.e., the slope is non-negative, x-values below
+ * the base predict the intercept, and large distances saturate, and may differ from the truncated floating-point
+ * predictions by one position. Error bounds are computed from the fixed-point predictions, so lookups within the
+ * bounds remain exact. The model occupies 32 bytes instead of the 16 bytes of a linear model, since the base and the
+ * shifts are stored alongside. Whether integer inference pays off depends on the processor: with fused multiply-add
+ * and fast conversions the floating-point path is short, see the fixed-point configurations of `rmi_lookup`.
+ *
+ * @tparam Model the type of the linear model that is converted, must provide slope() and intercept()
+ * @tparam X the type of x-values, must be an integer type
+ */
+template<typename Model = LinearRegression, typename X = uint64_t>
+class FixedPoint
+{
+    using x_type = X;
+    using bits_type = typename key_traits<X>::encoded_type;
+
+    static_assert(not std::is_floating_point<X>::value, "FixedPoint requires integer x-values.");
+
+    static constexpr std::int64_t max_term = std::int64_t(1) << 62; ///< Saturation limit of intercept and product.
+
+    private:
+    bits_type base_;            ///< The encoded x-value the distances are computed to.
+    std::int64_t intercept_;    ///< The y-value of the base.
+    std::uint64_t slope_;       ///< The mantissa of the slope.
+    std::uint8_t shift_left_;   ///< The shift of distances before multiplying for slopes of at least one.
+    std::uint8_t shift_right_;  ///< The shift of products after multiplying for slopes below one.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    FixedPoint() = default;
+
+    /**
+     * Builds the model on the distances of the given x-values to the first x-value.
+     * @param first, last iterators to the first and last x-value the model is fit on
+     * @param offset first y-value the model is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    FixedPoint(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : FixedPoint(Centered<Model, X>(first, last, offset, compression_factor)) { }
+
+    /**
+     * Builds the model on the distances of the given x-values to the first x-value with explicit y-values.
+     * @param first, last iterators to the first and last x-value the model is fit on
+     * @param y_first, y_last iterators to the first and last y-value the model is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt, typename YIt>
+    FixedPoint(RandomIt first, RandomIt last, YIt y_first, YIt y_last, double compression_factor)
+        : FixedPoint(Centered<Model, X>(first, last, y_first, y_last, compression_factor)) { }
+
+    /**
+     * Converts a model fit on distances to fixed point. The slope is scaled such that its mantissa uses all 64 bits,
+     * which keeps the relative rounding error of the slope below 2^-63.
+     * @param m the model fit on distances
+     */
+    explicit FixedPoint(const Centered<Model, X> &m) : base_(key_traits<X>::encode(m.base())) {
+        double slope = std::max(m.model().slope(), 0.); // negative slopes only stem from rounding
+        double intercept = std::clamp<double>(std::floor(m.model().intercept()), -max_term, max_term);
+        intercept_ = static_cast<std::int64_t>(intercept);
+        int exp = 0;
+        if (slope != 0.) std::frexp(slope, &exp); // slope = f * 2^exp with f in [0.5, 1)
+        shift_left_ = std::clamp(exp, 0, 63);
+        shift_right_ = std::clamp(-exp, 0, 63);
+        double mantissa = std::ldexp(slope, 64 + shift_right_ - shift_left_);
+        slope_ = static_cast<std::uint64_t>(std::min(mantissa, 0x1.fffffffffffffp63)); // below 2^64 unless exp > 63
+    }
+
+    /**
+     * Returns the estimated y-value of @p x. Only the high half of the 128-bit product is used, so that no 128-bit
+     * shift is needed, and distances are saturated before the left shift so that it cannot overflow.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    std::int64_t predict(const x_type x) const {
+        bits_type e = key_traits<X>::encode(x);
+        bits_type delta = e > base_ ? e - base_ : 0;
+        std::uint64_t d = std::min<bits_type>(delta, ~std::uint64_t(0) >> shift_left_);
+        std::uint64_t product = static_cast<uint128_t>(d << shift_left_) * slope_ >> 64;
+        return intercept_ + static_cast<std::int64_t>(std::min<std::uint64_t>(product >> shift_right_, max_term));
+    }
+
+    /**
+     * Returns the base the distances are computed to, encoded by key_traits.
+     * @return the encoded base
+     */
+    bits_type base() const { return base_; }
+
+    /**
+     * Returns the slope as a floating-point number.
+     * @return the slope
+     */
+    double slope() const { return std::ldexp(static_cast<double>(slope_), shift_left_ - shift_right_ - 64); }
+
+    /**
+     * Returns the y-value of the base.
+     * @return the intercept
+     */
+    std::int64_t intercept() const { return intercept_; }
+
+    /**
+     * Returns the size of the model in bytes, including padding.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() { return sizeof(FixedPoint); }
+
+    /**
+     * Writes the mathematical representation of the model to an output stream.
+     * @param out output stream to write the model to
+     * @param m the model
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const FixedPoint &m) {
+        return out << "(((x - " << static_cast<double>(m.base()) << ") << " << unsigned(m.shift_left_) << ") * "
+                   << m.slope_ << " >> " << 64 + m.shift_right_ << ") + " << m.intercept();
+    }
+};
+
 } // namespace rmi
@@ -1,8 +1,20 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "rmi/util/compact_vector.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/serialize.hpp"
+#include "rmi/util/simd.hpp"
+
 
 namespace rmi {
 
@@ -15,28 +27,65 @@ struct Approx {
     std::size_t hi;  ///< The upper bound of the search range.
 };
 
+/**
+ * Sampling parameters for building an index on a sample of the keys. Layer1 is trained on every k-th key and each
+ * layer2 model on every k-th distinct key of its segment, where k is the #stride() of the sampling. Segment boundaries
+ * and error bounds are still exact.
+ */
+struct Sampling {
+    double rate = 1.; ///< The fraction of the keys the models are trained on, in (0, 1].
+
+    /**
+     * Returns the distance between two sampled keys.
+     * @return the distance between two sampled keys
+     */
+    std::size_t stride() const { return rate < 1. ? std::max<std::size_t>(std::lround(1. / rate), 1) : 1; }
+};
+
+template<typename Index> class RmiBuilder;
+
 /**
  * This is a reimplementation of a two-layer recursive model index (RMI) supporting a variety of (monotonic) models.
  * RMIs were invented by Kraska et al. (https://dl.acm.org/doi/epdf/10.1145/3183713.3196909).
  *
  * Note that this is the base class which does not provide error bounds.
  *
+ * Keys may occur more than once. Since all occurrences of a key belong to the same segment, each layer2 model is
+ * trained on the distinct keys of its segment and the positions of their first occurrences, and the error bounds of
+ * derived classes only cover first occurrences. Thus, a lower-bound search within the bounds finds the first
+ * occurrence of every indexed key, and the remaining occurrences follow it.
+ *
+ * Given a Sampling with a rate below 1, the models are trained on a sample of the keys, which trades prediction
+ * accuracy for build time. Without error bounds, layer2 only evaluates layer1 on every k-th key and on the keys around
+ * segment boundaries. Error bounds of derived classes are still computed on all keys, so lookups remain correct.
+ *
+ * The layer2 models are allocated by @p Allocator, e.g., HugePageAllocator to back large layer2 arrays with huge
+ * pages. Indexes own their layer2 models and can be moved but not copied.
+ *
  * @tparam Key the type of the keys to be indexed
  * @tparam Layer1 the type of the model used in layer1
  * @tparam Layer2 the type of the models used in layer2
+ * @tparam Allocator the allocator used for the layer2 models, rebound to the layer2 type
  */
-template<typename Key, typename Layer1, typename Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>>
 class Rmi
 {
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<layer2_type>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
 
     protected:
-    std::size_t n_keys_;      ///< The number of keys the index was built on.
-    std::size_t layer2_size_; ///< The number of models in layer2.
-    layer1_type l1_;          ///< The layer1 model.
-    layer2_type *l2_;         ///< The array of layer2 models.
+    std::size_t n_keys_ = 0;              ///< The number of keys the index was built on.
+    std::size_t layer2_size_ = 0;         ///< The number of models in layer2.
+    layer1_type l1_;                      ///< The layer1 model.
+    layer2_type *l2_ = nullptr;           ///< The array of layer2 models.
+    allocator_type alloc_;                ///< The allocator of the layer2 models.
+    std::shared_ptr<const void> mapping_; ///< The file mapping #l2_ points into if the index was loaded from a file.
+
+    static constexpr char file_magic[8] = {'R', 'M', 'I', 'I', 'N', 'D', 'E', 'X'}; ///< Identifies index files.
+    static constexpr std::uint32_t file_version = 1; ///< The version of the file format.
 
     public:
     /**
@@ -48,52 +97,126 @@ class Rmi
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2
+     * @param alloc the allocator used for the layer2 models
      */
-    Rmi(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : Rmi(keys.begin(), keys.end(), layer2_size) { }
+    Rmi(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::size_t n_threads = 1,
+        const Allocator &alloc = Allocator())
+        : Rmi(keys.begin(), keys.end(), layer2_size, n_threads, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
+     *
+     * With @p n_threads > 1, the keys are split into partitions at segment boundaries and the layer2 models of each
+     * partition are trained by a separate thread. The resulting index is identical to the one built sequentially.
+     *
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2
+     * @param alloc the allocator used for the layer2 models
      */
     template<typename RandomIt>
-    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size)
-        : n_keys_(std::distance(first, last))
-        , layer2_size_(layer2_size)
-    {
-        // Train layer1.
-        l1_ = layer1_type(first, last, 0, static_cast<double>(layer2_size) / n_keys_); // train with compression
+    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t n_threads = 1,
+        const Allocator &alloc = Allocator())
+        : Rmi(first, last, layer2_size, Sampling(), n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2
+     * @param alloc the allocator used for the layer2 models
+     */
+    Rmi(const std::vector<key_type> &keys, const std::size_t layer2_size, const Sampling sampling,
+        const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : Rmi(keys.begin(), keys.end(), layer2_size, sampling, n_threads, alloc) { }
 
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size, const Sampling sampling,
+        const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : Rmi(first, last, layer2_size, layer1_only, sampling, alloc)
+    {
         // Train layer2.
-        l2_ = new layer2_type[layer2_size];
-        std::size_t segment_start = 0;
-        std::size_t segment_id = 0;
-        // Assign each key to its segment.
-        for (std::size_t i = 0; i != n_keys_; ++i) {
-            auto pos = first + i;
-            std::size_t pred_segment_id = get_segment_id(*pos);
-            // If a key is assigned to a new segment, all models must be trained up to the new segment.
-            if (pred_segment_id > segment_id) {
-                new (&l2_[segment_id]) layer2_type(first + segment_start, pos, segment_start);
-                for (std::size_t j = segment_id + 1; j < pred_segment_id; ++j) {
-                    new (&l2_[j]) layer2_type(pos - 1, pos, i - 1); // train other models on last key in previous segment
-                }
-                segment_id = pred_segment_id;
-                segment_start = i;
-            }
-        }
-        // Train remaining models.
-        new (&l2_[segment_id]) layer2_type(first + segment_start, last, segment_start);
-        for (std::size_t j = segment_id + 1; j < layer2_size; ++j) {
-            new (&l2_[j]) layer2_type(last - 1, last, n_keys_ - 1); // train remaining models on last key
-        }
+        build_layer2(first, n_threads, sampling, [](std::size_t, std::size_t, std::size_t, std::size_t) { });
+    }
+
+    /**
+     * Move constructor.
+     * @param other index to be moved
+     */
+    Rmi(Rmi &&other) noexcept
+        : n_keys_(std::exchange(other.n_keys_, 0))
+        , layer2_size_(std::exchange(other.layer2_size_, 0))
+        , l1_(std::move(other.l1_))
+        , l2_(std::exchange(other.l2_, nullptr))
+        , alloc_(std::move(other.alloc_))
+        , mapping_(std::move(other.mapping_)) { }
+
+    /**
+     * Move assignment operator. The layer2 models previously owned by this index are released by @p other.
+     * @param other index to be moved
+     * @return this index
+     */
+    Rmi & operator=(Rmi &&other) noexcept {
+        swap(other);
+        return *this;
     }
 
+    Rmi(const Rmi&) = delete;
+    Rmi & operator=(const Rmi&) = delete;
+
     /**
      * Destructor.
      */
-    ~Rmi() { delete[] l2_; }
+    ~Rmi() {
+        if (l2_ and not mapping_) {
+            std::destroy_n(l2_, layer2_size_);
+            allocator_traits::deallocate(alloc_, l2_, layer2_size_);
+        }
+    }
+
+    /**
+     * Exchanges the contents of this index with @p other without copying the layer2 models.
+     * @param other index to exchange contents with
+     */
+    void swap(Rmi &other) noexcept {
+        using std::swap;
+        swap(n_keys_, other.n_keys_);
+        swap(layer2_size_, other.layer2_size_);
+        swap(l1_, other.l1_);
+        swap(l2_, other.l2_);
+        swap(alloc_, other.alloc_);
+        swap(mapping_, other.mapping_);
+    }
+
+    /**
+     * Writes the index to the file @p filename.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        Writer out(filename);
+        save_layers(out, 0);
+    }
+
+    /**
+     * Loads an index from the file @p filename written by #save(). The file is mapped into memory and the layer2
+     * models are used in place without copying.
+     * @param filename name of the file to read from
+     * @return the index
+     */
+    static Rmi load(const std::string &filename) {
+        Reader in(filename);
+        return Rmi(in, 0);
+    }
 
     /**
      * Returns the id of the segment @p key belongs to.
@@ -101,7 +224,18 @@ class Rmi
      * @return segment id of the given key
      */
     std::size_t get_segment_id(const key_type key) const {
-        return std::clamp<double>(l1_.predict(key), 0, layer2_size_ - 1);
+        return clamp_prediction(l1_.predict(key), layer2_size_ - 1);
+    }
+
+    /**
+     * Writes the ids of the segments @p n keys belong to to @p out. Linear and cubic layer1 models are evaluated on
+     * several keys at once using SIMD instructions if available.
+     * @param keys array of keys to get segment ids for
+     * @param n number of keys
+     * @param out array to write the segment ids to
+     */
+    void get_segment_ids(const key_type *keys, const std::size_t n, std::size_t *out) const {
+        predict_clamped(l1_, keys, n, layer2_size_ - 1, out);
     }
 
     /**
@@ -109,10 +243,57 @@ class Rmi
      * @param key to search for
      * @return position estimate and search bounds
      */
-    Approx search(const key_type key) const {
-        auto segment_id = get_segment_id(key);
-        std::size_t pred = std::clamp<double>(l2_[segment_id].predict(key), 0, n_keys_ - 1);
-        return {pred, 0, n_keys_};
+    Approx search(const key_type key) const { return search(key, get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return search_bounds(predict(key, segment_id), segment_id);
+    }
+
+    /**
+     * Returns search bounds around the position estimate @p pred of a key in segment @p segment_id.
+     * @param pred position estimate of the key
+     * @param segment_id of the key
+     * @return position estimate and search bounds
+     */
+    Approx search_bounds(const std::size_t pred, const std::size_t) const { return {pred, 0, n_keys_}; }
+
+    /**
+     * Prefetches the layer2 model of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const { __builtin_prefetch(&l2_[segment_id]); }
+
+    /**
+     * Writes position estimates and search bounds for @p n keys to @p out. Lookups are interleaved in groups of
+     * #batch_size keys so that the cache misses of different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    void search_batch(const key_type *keys, const std::size_t n, Approx *out) const {
+        search_batch_impl(*this, keys, n, out);
+    }
+
+    /**
+     * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each
+     * of the @p n keys to @p out. Lookups are interleaved in groups of #batch_size keys so that the cache misses of
+     * different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename RandomIt, typename Search>
+    void lower_bound_batch(const key_type *keys, const std::size_t n, RandomIt data, Search search,
+                           std::size_t *out) const {
+        lower_bound_batch_impl(*this, keys, n, data, search, out);
     }
 
     /**
@@ -127,6 +308,19 @@ class Rmi
      */
     std::size_t layer2_size() const { return layer2_size_; }
 
+    /**
+     * Returns the layer1 model.
+     * @return the layer1 model
+     */
+    const layer1_type & layer1() const { return l1_; }
+
+    /**
+     * Returns the layer2 model of segment @p segment_id.
+     * @param segment_id of the segment
+     * @return the layer2 model of the segment
+     */
+    const layer2_type & layer2(const std::size_t segment_id) const { return l2_[segment_id]; }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
@@ -134,16 +328,378 @@ class Rmi
     std::size_t size_in_bytes() {
         return l1_.size_in_bytes() + layer2_size_ * l2_[0].size_in_bytes() + sizeof(n_keys_) + sizeof(layer2_size_);
     }
+
+    static constexpr std::size_t batch_size = 16; ///< The number of lookups interleaved by batched lookups.
+
+    protected:
+    template<typename Index> friend class RmiBuilder;
+
+    /**
+     * Sets the layer1 model to @p l1 and allocates @p layer2_size default-constructed layer2 models. RmiBuilder trains
+     * the layer2 models while the keys are streamed.
+     * @param l1 the layer1 model
+     * @param layer2_size the number of models in layer2
+     */
+    void allocate_layers(const layer1_type &l1, const std::size_t layer2_size) {
+        l1_ = l1;
+        layer2_size_ = layer2_size;
+        l2_ = allocator_traits::allocate(alloc_, layer2_size);
+        std::uninitialized_default_construct_n(l2_, layer2_size);
+    }
+
+    /**
+     * Does nothing since the index has no error bounds.
+     */
+    void assign_bounds(const std::vector<std::size_t> &, const std::vector<std::size_t> &) { }
+
+    /**
+     * Loads the layers of an index from @p in and checks that the file was written by an index of the same type.
+     * @param in reader to read from
+     * @param bounds_id identifies the type of error bounds of the index
+     */
+    Rmi(Reader &in, const std::uint32_t bounds_id) {
+        if (std::memcmp(in.read(sizeof(file_magic)), file_magic, sizeof(file_magic)) != 0) in.fail();
+        in.expect(file_version);
+        in.expect(bounds_id);
+        in.expect(std::uint32_t(sizeof(key_type)));
+        in.expect(std::uint32_t(sizeof(layer1_type)));
+        in.expect(std::uint32_t(sizeof(layer2_type)));
+        in.expect(std::uint32_t(alignof(layer2_type)));
+        n_keys_ = in.read<std::size_t>();
+        layer2_size_ = in.read<std::size_t>();
+        in.align();
+        l1_ = in.read<layer1_type>();
+        in.align();
+        // The mapping is read-only, models are never modified after loading.
+        l2_ = const_cast<layer2_type*>(static_cast<const layer2_type*>(in.read(layer2_size_ * sizeof(layer2_type))));
+        in.align();
+        mapping_ = in.mapping();
+    }
+
+    /**
+     * Writes the header and the layers of the index to @p out. All sections are aligned to #file_alignment bytes so
+     * that they can be used in place after mapping the file into memory.
+     * @param out writer to write to
+     * @param bounds_id identifies the type of error bounds of the index
+     */
+    void save_layers(Writer &out, const std::uint32_t bounds_id) const {
+        out.write(file_magic, sizeof(file_magic));
+        out.write(file_version);
+        out.write(bounds_id);
+        out.write(std::uint32_t(sizeof(key_type)));
+        out.write(std::uint32_t(sizeof(layer1_type)));
+        out.write(std::uint32_t(sizeof(layer2_type)));
+        out.write(std::uint32_t(alignof(layer2_type)));
+        out.write(n_keys_);
+        out.write(layer2_size_);
+        out.align();
+        out.write(l1_);
+        out.align();
+        static_assert(std::is_trivially_copyable<layer2_type>::value, "layer2 models must be trivially copyable");
+        out.write(l2_, layer2_size_ * sizeof(layer2_type));
+        out.align();
+    }
+
+    /**
+     * Tag type to select the constructor that only trains layer1.
+     */
+    struct layer1_only_t { };
+    static constexpr layer1_only_t layer1_only{}; ///< Tag to select the constructor that only trains layer1.
+
+    /**
+     * Trains layer1 on a sample of the sorted keys in the range [first, last) and allocates, but does not train, the
+     * layer2 models. Derived classes use this constructor to train layer2 by #build_layer2 and compute their error
+     * bounds in the same pass.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys layer1 is trained on
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size, layer1_only_t, const Sampling sampling,
+        const Allocator &alloc = Allocator())
+        : n_keys_(std::distance(first, last))
+        , layer2_size_(layer2_size)
+        , alloc_(alloc)
+    {
+        // Train layer1.
+        const double compression = static_cast<double>(layer2_size) / n_keys_;
+        const std::size_t stride = sampling.stride();
+        if (stride == 1) {
+            l1_ = layer1_type(first, last, 0, compression); // train with compression
+        } else {
+            // Train on every stride-th key and the last key at their positions.
+            std::vector<key_type> sample;
+            std::vector<std::size_t> positions;
+            sample.reserve(n_keys_ / stride + 2);
+            positions.reserve(n_keys_ / stride + 2);
+            for (std::size_t i = 0; i < n_keys_; i += stride) {
+                sample.push_back(*(first + i));
+                positions.push_back(i);
+            }
+            if (n_keys_ != 0 and positions.back() != n_keys_ - 1) {
+                sample.push_back(*(last - 1));
+                positions.push_back(n_keys_ - 1);
+            }
+            l1_ = layer1_type(sample.begin(), sample.end(), positions.begin(), positions.end(), compression);
+        }
+
+        // Allocate layer2.
+        l2_ = allocator_traits::allocate(alloc_, layer2_size);
+        std::uninitialized_default_construct_n(l2_, layer2_size);
+    }
+
+    /**
+     * Returns the position estimate of the layer2 model of segment @p segment_id for @p key clamped to the valid
+     * range of positions.
+     * @param key to predict the position of
+     * @param segment_id of the given key
+     * @return position estimate
+     */
+    std::size_t predict(const key_type key, const std::size_t segment_id) const {
+        return clamp_prediction(l2_[segment_id].predict(key), n_keys_ - 1);
+    }
+
+    /**
+     * Writes the position estimates of the layer2 models of segments @p segment_ids for @p n keys clamped to the valid
+     * range of positions to @p out. Linear layer2 models are evaluated on several keys at once using SIMD instructions
+     * if available.
+     * @param keys array of keys to predict the positions of
+     * @param segment_ids array of the segment ids of the keys
+     * @param n number of keys
+     * @param out array to write the position estimates to
+     */
+    void predict(const key_type *keys, const std::size_t *segment_ids, const std::size_t n, std::size_t *out) const {
+        predict_clamped(l2_, segment_ids, keys, n, n_keys_ - 1, out);
+    }
+
+    /**
+     * Trains the layer2 models on a sample of the sorted keys starting at @p first using @p n_threads threads. Right
+     * after the model of a non-empty segment is trained, @p visit is called with the partition, the segment id, and
+     * the boundaries [begin, end) of all keys in the segment. Segments of different partitions are visited by
+     * different threads, segments of the same partition are visited in order.
+     * @param first iterator to the first of the keys the index is built on
+     * @param n_threads the number of threads used for training layer2
+     * @param sampling the sampling of the keys the layer2 models are trained on
+     * @param visit function called as visit(partition, segment_id, begin, end) for each non-empty segment
+     * @return the number of partitions, which is at most max(@p n_threads, 1)
+     */
+    template<typename RandomIt, typename Visit>
+    std::size_t build_layer2(RandomIt first, const std::size_t n_threads, const Sampling sampling, Visit visit) {
+        auto partitions = partition(first, n_threads);
+        parallel_for(partitions.size() - 1, [&](std::size_t p) {
+            auto visit_partition = [&](std::size_t segment_id, std::size_t begin, std::size_t end) {
+                visit(p, segment_id, begin, end);
+            };
+            train_layer2(first, partitions[p], partitions[p + 1], sampling.stride(), visit_partition);
+        });
+        return partitions.size() - 1;
+    }
+
+    /**
+     * Performs batched lookups on @p index using group prefetching. For each group of #batch_size keys, the segment ids
+     * are computed and the corresponding layer2 models and bounds are prefetched before any of them is accessed. Then,
+     * the position estimates of the group are computed before the search bounds of each key are derived. Both the
+     * segment ids and the position estimates are computed using SIMD instructions where available.
+     * @tparam Index the type of the index
+     * @param index to perform the lookups on
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    template<typename Index>
+    static void search_batch_impl(const Index &index, const key_type *keys, const std::size_t n, Approx *out) {
+        std::size_t segment_ids[batch_size];
+        std::size_t preds[batch_size];
+        for (std::size_t i = 0; i < n; i += batch_size) {
+            const std::size_t m = std::min(batch_size, n - i);
+            index.get_segment_ids(keys + i, m, segment_ids);
+            for (std::size_t j = 0; j != m; ++j)
+                index.prefetch_segment(segment_ids[j]);
+            index.predict(keys + i, segment_ids, m, preds);
+            for (std::size_t j = 0; j != m; ++j)
+                out[i + j] = index.search_bounds(preds[j], segment_ids[j]);
+        }
+    }
+
+    /**
+     * Performs batched lookups including error correction on @p index using group prefetching. In addition to the
+     * stages of #search_batch_impl, the keys at the estimated positions are prefetched before the search is started.
+     * @tparam Index the type of the index
+     * @tparam RandomIt the type of the iterator to the sorted keys
+     * @tparam Search the type of the search algorithm
+     * @param index to perform the lookups on
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename Index, typename RandomIt, typename Search>
+    static void lower_bound_batch_impl(const Index &index, const key_type *keys, const std::size_t n, RandomIt data,
+                                       Search search, std::size_t *out) {
+        std::size_t segment_ids[batch_size];
+        std::size_t preds[batch_size];
+        Approx ranges[batch_size];
+        for (std::size_t i = 0; i < n; i += batch_size) {
+            const std::size_t m = std::min(batch_size, n - i);
+            index.get_segment_ids(keys + i, m, segment_ids);
+            for (std::size_t j = 0; j != m; ++j)
+                index.prefetch_segment(segment_ids[j]);
+            index.predict(keys + i, segment_ids, m, preds);
+            for (std::size_t j = 0; j != m; ++j) {
+                ranges[j] = index.search_bounds(preds[j], segment_ids[j]);
+                __builtin_prefetch(&*(data + ranges[j].pos));
+            }
+            for (std::size_t j = 0; j != m; ++j) {
+                auto pos = search(data + ranges[j].lo, data + ranges[j].hi, data + ranges[j].pos, keys[i + j]);
+                out[i + j] = std::distance(data, pos);
+            }
+        }
+    }
+
+    /**
+     * Splits the sorted keys starting at @p first into at most @p n_partitions partitions of roughly equal size such
+     * that no segment spans more than one partition.
+     * @param first iterator to the first of the keys the index is built on
+     * @param n_partitions the maximum number of partitions
+     * @return vector of partition boundaries, starting with 0 and ending with the number of keys
+     */
+    template<typename RandomIt>
+    std::vector<std::size_t> partition(RandomIt first, const std::size_t n_partitions) const {
+        std::vector<std::size_t> partitions{0};
+        for (std::size_t p = 1; p < n_partitions; ++p) {
+            std::size_t i = std::max(partitions.back() + 1, n_keys_ * p / n_partitions);
+            if (i >= n_keys_) break;
+            // Move the boundary to the start of the next segment.
+            std::size_t segment_id = get_segment_id(*(first + i - 1));
+            auto pos = std::partition_point(first + i, first + n_keys_, [&](const key_type key) {
+                return get_segment_id(key) == segment_id;
+            });
+            i = std::distance(first, pos);
+            if (i >= n_keys_) break;
+            partitions.push_back(i);
+        }
+        partitions.push_back(n_keys_);
+        return partitions;
+    }
+
+    /**
+     * Trains the layer2 models of all segments of the keys in the partition [begin, end) as well as the models of
+     * empty segments preceding them. The models of empty segments following the last partition are trained as well.
+     * The end of a segment is found by probing every @p stride-th key and searching the boundary between the last two
+     * probes, which relies on segment ids being monotonic in the keys.
+     * @param first iterator to the first of the keys the index is built on
+     * @param begin, end the boundaries of the partition
+     * @param stride the distance between two keys sampled for training
+     * @param visit function called as visit(segment_id, begin, end) after the model of a non-empty segment is trained
+     */
+    template<typename RandomIt, typename Visit>
+    void train_layer2(RandomIt first, const std::size_t begin, const std::size_t end, const std::size_t stride,
+                      Visit visit) {
+        std::vector<key_type> distinct;      // buffer for the distinct keys of segments with duplicates
+        std::vector<std::size_t> positions;  // buffer for the positions of their first occurrences
+        std::size_t segment_start = begin;
+        std::size_t segment_id = 0;
+        if (begin != 0) {
+            // The previous segment belongs to the previous partition, only train the empty segments in between.
+            auto pos = first + begin;
+            segment_id = get_segment_id(*pos);
+            for (std::size_t j = get_segment_id(*(pos - 1)) + 1; j < segment_id; ++j) {
+                new (&l2_[j]) layer2_type(pos - 1, pos, begin - 1); // train models on last key in previous segment
+            }
+        }
+        auto in_segment = [&](const key_type key) { return get_segment_id(key) <= segment_id; };
+        while (true) {
+            // Find the end of the current segment.
+            std::size_t lo = segment_start; // keys before lo belong to the segment
+            std::size_t hi = segment_start; // next key to probe
+            while (hi < end and in_segment(*(first + hi))) {
+                lo = hi + 1;
+                hi += stride;
+            }
+            auto pos = std::partition_point(first + lo, first + std::min(hi, end), in_segment);
+            std::size_t i = std::distance(first, pos);
+            if (i == end) break;
+            // If a key is assigned to a new segment, all models must be trained up to the new segment.
+            std::size_t pred_segment_id = get_segment_id(*pos);
+            train_segment(first, segment_id, segment_start, i, stride, distinct, positions);
+            visit(segment_id, segment_start, i);
+            for (std::size_t j = segment_id + 1; j < pred_segment_id; ++j) {
+                if (i == 0)
+                    new (&l2_[j]) layer2_type(pos, pos + 1, 0); // train leading models on first key
+                else
+                    new (&l2_[j]) layer2_type(pos - 1, pos, i - 1); // train other models on last key before
+            }
+            segment_id = pred_segment_id;
+            segment_start = i;
+        }
+        // Train last model of the partition.
+        train_segment(first, segment_id, segment_start, end, stride, distinct, positions);
+        visit(segment_id, segment_start, end);
+        if (end == n_keys_) {
+            auto last = first + n_keys_;
+            for (std::size_t j = segment_id + 1; j < layer2_size_; ++j) {
+                new (&l2_[j]) layer2_type(last - 1, last, n_keys_ - 1); // train remaining models on last key
+            }
+        }
+    }
+
+    /**
+     * Trains the layer2 model of segment @p segment_id on the keys in [begin, end). If the segment contains duplicate
+     * keys, the model is trained on each distinct key once at the position of its first occurrence, so that it
+     * predicts where a lower-bound search ends rather than the middle of a run of duplicates. With a @p stride
+     * greater than 1, the model is trained on the first occurrences of every stride-th key and the last key, skipping
+     * runs of duplicates by binary search.
+     * @param first iterator to the first of the keys the index is built on
+     * @param segment_id of the segment
+     * @param begin, end the boundaries of the keys in the segment
+     * @param stride the distance between two keys sampled for training
+     * @param distinct buffer for the distinct keys of the segment
+     * @param positions buffer for the positions of the first occurrences of the distinct keys
+     */
+    template<typename RandomIt>
+    void train_segment(RandomIt first, const std::size_t segment_id, const std::size_t begin, const std::size_t end,
+                       const std::size_t stride, std::vector<key_type> &distinct, std::vector<std::size_t> &positions) {
+        if (stride > 1) {
+            distinct.clear();
+            positions.clear();
+            for (std::size_t i = begin; i < end; ) {
+                distinct.push_back(*(first + i));
+                positions.push_back(i);
+                // Advance to the first occurrence of the key a stride ahead, or past the run of the current key.
+                auto next = first + std::min(i + stride, end - 1);
+                auto pos = *next == *(first + i) ? std::upper_bound(first + i, first + end, *next)
+                                                 : std::lower_bound(first + i + 1, next + 1, *next);
+                i = std::distance(first, pos);
+            }
+            new (&l2_[segment_id])
+                layer2_type(distinct.begin(), distinct.end(), positions.begin(), positions.end(), 1.);
+            return;
+        }
+        if (std::adjacent_find(first + begin, first + end) == first + end) { // no duplicates
+            new (&l2_[segment_id]) layer2_type(first + begin, first + end, begin);
+            return;
+        }
+        distinct.clear();
+        positions.clear();
+        for (std::size_t i = begin; i != end; ++i) {
+            if (i != begin and *(first + i) == *(first + i - 1)) continue;
+            distinct.push_back(*(first + i));
+            positions.push_back(i);
+        }
+        new (&l2_[segment_id]) layer2_type(distinct.begin(), distinct.end(), positions.begin(), positions.end(), 1.);
+    }
 };
 
 
 /**
  * Recursive model index with global absolute bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiGAbs : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>>
+class RmiGAbs : public Rmi<Key, Layer1, Layer2, Allocator>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
@@ -161,29 +717,67 @@ class RmiGAbs : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
-    RmiGAbs(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiGAbs(keys.begin(), keys.end(), layer2_size) { }
+    RmiGAbs(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::size_t n_threads = 1,
+               const Allocator &alloc = Allocator())
+        : RmiGAbs(keys.begin(), keys.end(), layer2_size, n_threads, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    RmiGAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t n_threads = 1,
+            const Allocator &alloc = Allocator())
+        : RmiGAbs(first, last, layer2_size, Sampling(), n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    RmiGAbs(const std::vector<key_type> &keys, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : RmiGAbs(keys.begin(), keys.end(), layer2_size, sampling, n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
     template<typename RandomIt>
-    RmiGAbs(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
-        // Compute global absolute errror bounds.
-        error_ = 0;
-        for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
-            key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-            if (pred > i) { // overestimation
-                error_ = std::max(error_, pred - i);
-            } else { // underestimation
-                error_ = std::max(error_, i - pred);
+    RmiGAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, base_type::layer1_only, sampling, alloc)
+    {
+        // Train layer2 and compute global absolute errror bounds of each segment right after training its model.
+        std::vector<std::size_t> errors(std::max<std::size_t>(n_threads, 1), 0); // error bound per partition
+        base_type::build_layer2(first, n_threads, sampling, [&](std::size_t p, std::size_t segment_id,
+                                                               std::size_t begin, std::size_t end) {
+            std::size_t error = errors[p];
+            for (std::size_t i = begin; i != end; ++i) {
+                if (i != begin and *(first + i) == *(first + i - 1)) continue; // only first occurrences are bounded
+                std::size_t pred = base_type::predict(*(first + i), segment_id);
+                if (pred > i) { // overestimation
+                    error = std::max(error, pred - i);
+                } else { // underestimation
+                    error = std::max(error, i - pred);
+                }
             }
-        }
+            errors[p] = error;
+        });
+        error_ = *std::max_element(errors.begin(), errors.end());
     }
 
     /**
@@ -191,29 +785,119 @@ class RmiGAbs : public Rmi<Key, Layer1, Layer2>
      * @param key to search for
      * @return position estimate and search bounds
      */
-    Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return search_bounds(base_type::predict(key, segment_id), segment_id);
+    }
+
+    /**
+     * Returns search bounds around the position estimate @p pred of a key in segment @p segment_id.
+     * @param pred position estimate of the key
+     * @param segment_id of the key
+     * @return position estimate and search bounds
+     */
+    Approx search_bounds(const std::size_t pred, const std::size_t) const {
         std::size_t lo = pred > error_ ? pred - error_ : 0;
         std::size_t hi = std::min(pred + error_ + 1, base_type::n_keys_);
         return {pred, lo, hi};
     }
 
+    /**
+     * Writes position estimates and search bounds for @p n keys to @p out. Lookups are interleaved in groups of
+     * #batch_size keys so that the cache misses of different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    void search_batch(const key_type *keys, const std::size_t n, Approx *out) const {
+        base_type::search_batch_impl(*this, keys, n, out);
+    }
+
+    /**
+     * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each
+     * of the @p n keys to @p out. Lookups are interleaved in groups of #batch_size keys so that the cache misses of
+     * different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename RandomIt, typename Search>
+    void lower_bound_batch(const key_type *keys, const std::size_t n, RandomIt data, Search search,
+                           std::size_t *out) const {
+        base_type::lower_bound_batch_impl(*this, keys, n, data, search, out);
+    }
+
+    /**
+     * Writes the index to the file @p filename.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        Writer out(filename);
+        base_type::save_layers(out, bounds_id);
+        out.write(error_);
+    }
+
+    /**
+     * Loads an index from the file @p filename written by #save(). The file is mapped into memory and the layer2
+     * models are used in place without copying.
+     * @param filename name of the file to read from
+     * @return the index
+     */
+    static RmiGAbs load(const std::string &filename) {
+        Reader in(filename);
+        return RmiGAbs(in);
+    }
+
+    /**
+     * Returns the error bound of all segments.
+     * @return the error bound
+     */
+    std::size_t error() const { return error_; }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
     std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_); }
+
+    protected:
+    template<typename Index> friend class RmiBuilder;
+
+    static constexpr std::uint32_t bounds_id = 1; ///< Identifies global absolute bounds in index files.
+
+    /**
+     * Sets the error bound to the largest of the lower and upper errors of all segments.
+     * @param errors_lo, errors_hi the largest over- and underestimation of each segment
+     */
+    void assign_bounds(const std::vector<std::size_t> &errors_lo, const std::vector<std::size_t> &errors_hi) {
+        error_ = std::max(*std::max_element(errors_lo.begin(), errors_lo.end()),
+                          *std::max_element(errors_hi.begin(), errors_hi.end()));
+    }
+
+    /**
+     * Loads an index from @p in.
+     * @param in reader to read from
+     */
+    explicit RmiGAbs(Reader &in) : base_type(in, bounds_id) { error_ = in.read<std::size_t>(); }
 };
 
 
 /**
  * Recursive model index with global individual bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiGInd : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>>
+class RmiGInd : public Rmi<Key, Layer1, Layer2, Allocator>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
@@ -232,30 +916,71 @@ class RmiGInd : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
-    RmiGInd(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiGInd(keys.begin(), keys.end(), layer2_size) { }
+    RmiGInd(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::size_t n_threads = 1,
+               const Allocator &alloc = Allocator())
+        : RmiGInd(keys.begin(), keys.end(), layer2_size, n_threads, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
     template<typename RandomIt>
-    RmiGInd(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
-        // Compute global absolute errror bounds.
-        error_lo_ = 0;
-        error_hi_ = 0;
-        for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
-            key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-            if (pred > i) { // overestimation
-                error_lo_ = std::max(error_lo_, pred - i);
-            } else { // underestimation
-                error_hi_ = std::max(error_hi_, i - pred);
+    RmiGInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t n_threads = 1,
+            const Allocator &alloc = Allocator())
+        : RmiGInd(first, last, layer2_size, Sampling(), n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    RmiGInd(const std::vector<key_type> &keys, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : RmiGInd(keys.begin(), keys.end(), layer2_size, sampling, n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    RmiGInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, base_type::layer1_only, sampling, alloc)
+    {
+        // Train layer2 and compute global individual errror bounds of each segment right after training its model.
+        std::vector<std::size_t> errors_lo(std::max<std::size_t>(n_threads, 1), 0); // lower error bound per partition
+        std::vector<std::size_t> errors_hi(std::max<std::size_t>(n_threads, 1), 0); // upper error bound per partition
+        base_type::build_layer2(first, n_threads, sampling, [&](std::size_t p, std::size_t segment_id,
+                                                               std::size_t begin, std::size_t end) {
+            std::size_t error_lo = errors_lo[p];
+            std::size_t error_hi = errors_hi[p];
+            for (std::size_t i = begin; i != end; ++i) {
+                if (i != begin and *(first + i) == *(first + i - 1)) continue; // only first occurrences are bounded
+                std::size_t pred = base_type::predict(*(first + i), segment_id);
+                if (pred > i) { // overestimation
+                    error_lo = std::max(error_lo, pred - i);
+                } else { // underestimation
+                    error_hi = std::max(error_hi, i - pred);
+                }
             }
-        }
+            errors_lo[p] = error_lo;
+            errors_hi[p] = error_hi;
+        });
+        error_lo_ = *std::max_element(errors_lo.begin(), errors_lo.end());
+        error_hi_ = *std::max_element(errors_hi.begin(), errors_hi.end());
     }
 
     /**
@@ -263,35 +988,320 @@ class RmiGInd : public Rmi<Key, Layer1, Layer2>
      * @param key to search for
      * @return position estimate and search bounds
      */
-    Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return search_bounds(base_type::predict(key, segment_id), segment_id);
+    }
+
+    /**
+     * Returns search bounds around the position estimate @p pred of a key in segment @p segment_id.
+     * @param pred position estimate of the key
+     * @param segment_id of the key
+     * @return position estimate and search bounds
+     */
+    Approx search_bounds(const std::size_t pred, const std::size_t) const {
         std::size_t lo = pred > error_lo_ ? pred - error_lo_ : 0;
         std::size_t hi = std::min(pred + error_hi_ + 1, base_type::n_keys_);
         return {pred, lo, hi};
     }
 
+    /**
+     * Writes position estimates and search bounds for @p n keys to @p out. Lookups are interleaved in groups of
+     * #batch_size keys so that the cache misses of different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    void search_batch(const key_type *keys, const std::size_t n, Approx *out) const {
+        base_type::search_batch_impl(*this, keys, n, out);
+    }
+
+    /**
+     * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each
+     * of the @p n keys to @p out. Lookups are interleaved in groups of #batch_size keys so that the cache misses of
+     * different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename RandomIt, typename Search>
+    void lower_bound_batch(const key_type *keys, const std::size_t n, RandomIt data, Search search,
+                           std::size_t *out) const {
+        base_type::lower_bound_batch_impl(*this, keys, n, data, search, out);
+    }
+
+    /**
+     * Writes the index to the file @p filename.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        Writer out(filename);
+        base_type::save_layers(out, bounds_id);
+        out.write(error_lo_);
+        out.write(error_hi_);
+    }
+
+    /**
+     * Loads an index from the file @p filename written by #save(). The file is mapped into memory and the layer2
+     * models are used in place without copying.
+     * @param filename name of the file to read from
+     * @return the index
+     */
+    static RmiGInd load(const std::string &filename) {
+        Reader in(filename);
+        return RmiGInd(in);
+    }
+
+    /**
+     * Returns the lower error bound of all segments.
+     * @return the lower error bound
+     */
+    std::size_t error_lo() const { return error_lo_; }
+
+    /**
+     * Returns the upper error bound of all segments.
+     * @return the upper error bound
+     */
+    std::size_t error_hi() const { return error_hi_; }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
     std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_lo_) + sizeof(error_hi_); }
+
+    protected:
+    template<typename Index> friend class RmiBuilder;
+
+    static constexpr std::uint32_t bounds_id = 2; ///< Identifies global individual bounds in index files.
+
+    /**
+     * Sets the error bounds to the largest lower and upper errors of all segments.
+     * @param errors_lo, errors_hi the largest over- and underestimation of each segment
+     */
+    void assign_bounds(const std::vector<std::size_t> &errors_lo, const std::vector<std::size_t> &errors_hi) {
+        error_lo_ = *std::max_element(errors_lo.begin(), errors_lo.end());
+        error_hi_ = *std::max_element(errors_hi.begin(), errors_hi.end());
+    }
+
+    /**
+     * Loads an index from @p in.
+     * @param in reader to read from
+     */
+    explicit RmiGInd(Reader &in) : base_type(in, bounds_id) {
+        error_lo_ = in.read<std::size_t>();
+        error_hi_ = in.read<std::size_t>();
+    }
+};
+
+
+/**
+ * Layout that stores the error bounds of the layer2 models in an array separate from the models. Bounds are stored
+ * with the narrowest width that fits the largest bound, which minimizes the index size.
+ */
+struct SplitLayout
+{
+    static constexpr std::uint32_t id = 0; ///< Identifies the layout in index files.
+
+    /**
+     * Storage for @p N error bounds per layer2 model.
+     * @tparam Layer2 the type of the models used in layer2
+     * @tparam N the number of error bounds per layer2 model
+     */
+    template<typename Layer2, std::size_t N>
+    class Bounds
+    {
+        public:
+        using layer2_type = Layer2; ///< The type of the layer2 models stored by the index.
+
+        private:
+        CompactVector errors_; ///< The error bounds of the layer2 models.
+
+        public:
+        /**
+         * Stores the error bounds @p errors, which hold @p N consecutive bounds per layer2 model.
+         * @param errors vector of error bounds
+         */
+        void assign(layer2_type *, const std::vector<std::size_t> &errors) { errors_ = CompactVector(errors); }
+
+        /**
+         * Returns the @p i-th error bound of segment @p segment_id.
+         * @param segment_id of the segment
+         * @param i the index of the error bound
+         * @return the error bound
+         */
+        std::size_t get(const layer2_type *, const std::size_t segment_id, const std::size_t i) const {
+            return errors_[N * segment_id + i];
+        }
+
+        /**
+         * Prefetches the error bounds of segment @p segment_id.
+         * @param segment_id of the segment
+         */
+        void prefetch(const layer2_type *, const std::size_t segment_id) const {
+            __builtin_prefetch(errors_.address(N * segment_id));
+        }
+
+        /**
+         * Writes the error bounds to @p out.
+         * @param out writer to write to
+         */
+        void save(Writer &out) const { errors_.save(out); }
+
+        /**
+         * Loads the error bounds from @p in. The bounds are used in place and stay valid as long as the mapping.
+         * @param in reader to read from
+         */
+        void load(Reader &in, layer2_type *) { errors_ = CompactVector::load(in); }
+
+        /**
+         * Returns the size of the error bounds in bytes.
+         * @return size of the error bounds in bytes
+         */
+        std::size_t size_in_bytes() const { return errors_.size_in_bytes(); }
+    };
+};
+
+/**
+ * Layout that packs each layer2 model together with its error bounds into a single record. Records are aligned to
+ * the next power of two of their size (at most a cache line), so that a lookup fetches the model and its bounds with a
+ * single cache miss.
+ *
+ * @tparam Bound the type used for storing error bounds, must be able to represent the largest error bound
+ */
+template<typename Bound = std::uint32_t>
+struct InterleavedLayout
+{
+    static constexpr std::uint32_t id = sizeof(Bound); ///< Identifies the layout in index files.
+
+    /**
+     * Storage for @p N error bounds per layer2 model.
+     * @tparam Layer2 the type of the models used in layer2
+     * @tparam N the number of error bounds per layer2 model
+     */
+    template<typename Layer2, std::size_t N>
+    class Bounds
+    {
+        public:
+        /**
+         * Record of a layer2 model and its error bounds.
+         */
+        struct alignas(std::min<std::size_t>(next_power_of_two(sizeof(Layer2) + N * sizeof(Bound)), 64))
+        layer2_type : Layer2
+        {
+            Bound errors[N]; ///< The error bounds of the layer2 model.
+
+            /**
+             * Default constructor.
+             */
+            layer2_type() = default;
+
+            /**
+             * Trains the layer2 model on the keys in the range [first, last).
+             * @param first, last iterators that define the range of keys the model is trained on
+             * @param offset the position of the first key
+             */
+            template<typename RandomIt>
+            layer2_type(RandomIt first, RandomIt last, std::size_t offset) : Layer2(first, last, offset) { }
+
+            /**
+             * Trains the layer2 model on the keys in the range [first, last) with explicit positions.
+             * @param first, last iterators that define the range of keys the model is trained on
+             * @param y_first, y_last iterators that define the range of positions of the keys
+             * @param compression_factor by which the positions are scaled
+             */
+            template<typename RandomIt, typename YIt>
+            layer2_type(RandomIt first, RandomIt last, YIt y_first, YIt y_last, double compression_factor)
+                : Layer2(first, last, y_first, y_last, compression_factor) { }
+
+            /**
+             * Returns the size of the record in bytes, including padding.
+             * @return size of the record in bytes
+             */
+            std::size_t size_in_bytes() { return sizeof(layer2_type); }
+        };
+
+        /**
+         * Stores the error bounds @p errors, which hold @p N consecutive bounds per layer2 model, in the records @p l2.
+         * Exits with an error if a bound does not fit into @p Bound.
+         * @param l2 array of layer2 records
+         * @param errors vector of error bounds
+         */
+        void assign(layer2_type *l2, const std::vector<std::size_t> &errors) {
+            const std::size_t max_error = errors.empty() ? 0 : *std::max_element(errors.begin(), errors.end());
+            if (max_error > std::numeric_limits<Bound>::max()) {
+                std::cerr << "Error: error bound " << max_error << " does not fit into the " << 8 * sizeof(Bound)
+                          << "-bit bounds of the interleaved layout, use a wider bound type." << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            for (std::size_t segment_id = 0; segment_id != errors.size() / N; ++segment_id) {
+                for (std::size_t i = 0; i != N; ++i)
+                    l2[segment_id].errors[i] = errors[N * segment_id + i];
+            }
+        }
+
+        /**
+         * Returns the @p i-th error bound of segment @p segment_id.
+         * @param l2 array of layer2 records
+         * @param segment_id of the segment
+         * @param i the index of the error bound
+         * @return the error bound
+         */
+        std::size_t get(const layer2_type *l2, const std::size_t segment_id, const std::size_t i) const {
+            return l2[segment_id].errors[i];
+        }
+
+        /**
+         * Does nothing since the error bounds share a cache line with the layer2 model.
+         */
+        void prefetch(const layer2_type *, const std::size_t) const { }
+
+        /**
+         * Does nothing since the error bounds are written as part of the layer2 records.
+         */
+        void save(Writer &) const { }
+
+        /**
+         * Does nothing since the error bounds are loaded as part of the layer2 records.
+         */
+        void load(Reader &, layer2_type *) { }
+
+        /**
+         * Returns zero since the error bounds are accounted for by the layer2 records.
+         * @return zero
+         */
+        std::size_t size_in_bytes() const { return 0; }
+    };
 };
 
 
 /**
  * Recursive model index with local absolute bounds.
+ *
+ * @tparam Layout the layout of the layer2 models and their error bounds, either SplitLayout or InterleavedLayout
+ * @tparam Allocator the allocator used for the layer2 models
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiLAbs : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Layout = SplitLayout,
+         typename Allocator = std::allocator<Layer2>>
+class RmiLAbs : public Rmi<Key, Layer1, typename Layout::template Bounds<Layer2, 1>::layer2_type, Allocator>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using bounds_type = typename Layout::template Bounds<Layer2, 1>;
+    using base_type = Rmi<Key, Layer1, typename bounds_type::layer2_type, Allocator>;
     using key_type = Key;
     using layer1_type = Layer1;
-    using layer2_type = Layer2;
+    using layer2_type = typename bounds_type::layer2_type;
 
     protected:
-    std::vector<std::size_t> errors_; ///< The error bounds of the layer2 models.
+    bounds_type errors_; ///< The error bounds of the layer2 models.
 
     public:
     /**
@@ -303,29 +1313,69 @@ class RmiLAbs : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
-    RmiLAbs(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiLAbs(keys.begin(), keys.end(), layer2_size) { }
+    RmiLAbs(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::size_t n_threads = 1,
+               const Allocator &alloc = Allocator())
+        : RmiLAbs(keys.begin(), keys.end(), layer2_size, n_threads, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    RmiLAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t n_threads = 1,
+            const Allocator &alloc = Allocator())
+        : RmiLAbs(first, last, layer2_size, Sampling(), n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    RmiLAbs(const std::vector<key_type> &keys, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : RmiLAbs(keys.begin(), keys.end(), layer2_size, sampling, n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
     template<typename RandomIt>
-    RmiLAbs(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
-        // Compute local absolute errror bounds.
-        errors_ = std::vector<std::size_t>(layer2_size);
-        for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
-            key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-            if (pred > i) { // overestimation
-                errors_[segment_id] = std::max(errors_[segment_id], pred - i);
-            } else { // underestimation
-                errors_[segment_id] = std::max(errors_[segment_id], i - pred);
+    RmiLAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, base_type::layer1_only, sampling, alloc)
+    {
+        // Train layer2 and compute local absolute errror bounds of each segment right after training its model.
+        // Partitions do not share segments, so threads write disjoint bounds.
+        std::vector<std::size_t> errors(layer2_size, 0);
+        base_type::build_layer2(first, n_threads, sampling, [&](std::size_t, std::size_t segment_id,
+                                                               std::size_t begin, std::size_t end) {
+            std::size_t error = 0;
+            for (std::size_t i = begin; i != end; ++i) {
+                if (i != begin and *(first + i) == *(first + i - 1)) continue; // only first occurrences are bounded
+                std::size_t pred = base_type::predict(*(first + i), segment_id);
+                if (pred > i) { // overestimation
+                    error = std::max(error, pred - i);
+                } else { // underestimation
+                    error = std::max(error, i - pred);
+                }
             }
-        }
+            errors[segment_id] = error;
+        });
+
+        errors_.assign(base_type::l2_, errors);
     }
 
     /**
@@ -333,49 +1383,144 @@ class RmiLAbs : public Rmi<Key, Layer1, Layer2>
      * @param key to search for
      * @return position estimate and search bounds
      */
-    Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        std::size_t err = errors_[segment_id];
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return search_bounds(base_type::predict(key, segment_id), segment_id);
+    }
+
+    /**
+     * Returns search bounds around the position estimate @p pred of a key in segment @p segment_id.
+     * @param pred position estimate of the key
+     * @param segment_id of the key
+     * @return position estimate and search bounds
+     */
+    Approx search_bounds(const std::size_t pred, const std::size_t segment_id) const {
+        std::size_t err = errors_.get(base_type::l2_, segment_id, 0);
         std::size_t lo = pred > err ? pred - err : 0;
         std::size_t hi = std::min(pred + err + 1, base_type::n_keys_);
         return {pred, lo, hi};
     }
 
+    /**
+     * Prefetches the layer2 model and the error bounds of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const {
+        base_type::prefetch_segment(segment_id);
+        errors_.prefetch(base_type::l2_, segment_id);
+    }
+
+    /**
+     * Writes position estimates and search bounds for @p n keys to @p out. Lookups are interleaved in groups of
+     * #batch_size keys so that the cache misses of different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    void search_batch(const key_type *keys, const std::size_t n, Approx *out) const {
+        base_type::search_batch_impl(*this, keys, n, out);
+    }
+
+    /**
+     * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each
+     * of the @p n keys to @p out. Lookups are interleaved in groups of #batch_size keys so that the cache misses of
+     * different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename RandomIt, typename Search>
+    void lower_bound_batch(const key_type *keys, const std::size_t n, RandomIt data, Search search,
+                           std::size_t *out) const {
+        base_type::lower_bound_batch_impl(*this, keys, n, data, search, out);
+    }
+
+    /**
+     * Writes the index to the file @p filename.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        Writer out(filename);
+        base_type::save_layers(out, bounds_id);
+        errors_.save(out);
+    }
+
+    /**
+     * Loads an index from the file @p filename written by #save(). The file is mapped into memory and the layer2
+     * models and error bounds are used in place without copying.
+     * @param filename name of the file to read from
+     * @return the index
+     */
+    static RmiLAbs load(const std::string &filename) {
+        Reader in(filename);
+        return RmiLAbs(in);
+    }
+
+    /**
+     * Returns the error bound of segment @p segment_id.
+     * @param segment_id of the segment
+     * @return the error bound of the segment
+     */
+    std::size_t error(const std::size_t segment_id) const { return errors_.get(base_type::l2_, segment_id, 0); }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size_in_bytes(); }
+
+    protected:
+    template<typename Index> friend class RmiBuilder;
+
+    /// Identifies local absolute bounds and their layout in index files.
+    static constexpr std::uint32_t bounds_id = 3 | Layout::id << 8;
+
+    /**
+     * Sets the error bound of each segment to the larger of its lower and upper error.
+     * @param errors_lo, errors_hi the largest over- and underestimation of each segment
+     */
+    void assign_bounds(const std::vector<std::size_t> &errors_lo, const std::vector<std::size_t> &errors_hi) {
+        std::vector<std::size_t> errors(errors_lo.size());
+        for (std::size_t i = 0; i != errors.size(); ++i)
+            errors[i] = std::max(errors_lo[i], errors_hi[i]);
+        errors_.assign(base_type::l2_, errors);
+    }
+
+    /**
+     * Loads an index from @p in.
+     * @param in reader to read from
+     */
+    explicit RmiLAbs(Reader &in) : base_type(in, bounds_id) { errors_.load(in, base_type::l2_); }
 };
 
 
 /**
  * Recursive model index with local individual bounds.
+ *
+ * @tparam Layout the layout of the layer2 models and their error bounds, either SplitLayout or InterleavedLayout
+ * @tparam Allocator the allocator used for the layer2 models
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiLInd : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Layout = SplitLayout,
+         typename Allocator = std::allocator<Layer2>>
+class RmiLInd : public Rmi<Key, Layer1, typename Layout::template Bounds<Layer2, 2>::layer2_type, Allocator>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using bounds_type = typename Layout::template Bounds<Layer2, 2>;
+    using base_type = Rmi<Key, Layer1, typename bounds_type::layer2_type, Allocator>;
     using key_type = Key;
     using layer1_type = Layer1;
-    using layer2_type = Layer2;
+    using layer2_type = typename bounds_type::layer2_type;
 
     protected:
-    /**
-     * Struct to store a lower and an upper error bound.
-     */
-    struct bounds {
-        std::size_t lo; ///< The lower error bound.
-        std::size_t hi; ///< The upper error bound.
-
-        /**
-         * Default constructor.
-         */
-        bounds() : lo(0), hi(0) { }
-    };
-
-    std::vector<bounds> errors_; ///< The error bounds of the layer2 models.
+    bounds_type errors_; ///< The lower and upper error bounds of the layer2 models.
 
     public:
     /**
@@ -387,31 +1532,71 @@ class RmiLInd : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
-    RmiLInd(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiLInd(keys.begin(), keys.end(), layer2_size) { }
+    RmiLInd(const std::vector<key_type> &keys, const std::size_t layer2_size, const std::size_t n_threads = 1,
+               const Allocator &alloc = Allocator())
+        : RmiLInd(keys.begin(), keys.end(), layer2_size, n_threads, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    template<typename RandomIt>
+    RmiLInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t n_threads = 1,
+            const Allocator &alloc = Allocator())
+        : RmiLInd(first, last, layer2_size, Sampling(), n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
+     */
+    RmiLInd(const std::vector<key_type> &keys, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : RmiLInd(keys.begin(), keys.end(), layer2_size, sampling, n_threads, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on a sample of the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param sampling the sampling of the keys the models are trained on
+     * @param n_threads the number of threads used for training layer2 and computing error bounds
+     * @param alloc the allocator used for the layer2 models
      */
     template<typename RandomIt>
-    RmiLInd(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
-        // Compute local individual errror bounds.
-        errors_ = std::vector<bounds>(layer2_size);
-        for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
-            key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-            if (pred > i) { // overestimation
-                std::size_t &lo = errors_[segment_id].lo;
-                lo = std::max(lo, pred - i);
-            } else { // underestimation
-                std::size_t &hi = errors_[segment_id].hi;
-                hi = std::max(hi, i - pred);
+    RmiLInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const Sampling sampling,
+            const std::size_t n_threads = 1, const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, base_type::layer1_only, sampling, alloc)
+    {
+        // Train layer2 and compute local individual errror bounds of each segment right after training its model.
+        // Partitions do not share segments, so threads write disjoint bounds.
+        std::vector<std::size_t> errors(2 * layer2_size, 0);
+        base_type::build_layer2(first, n_threads, sampling, [&](std::size_t, std::size_t segment_id,
+                                                               std::size_t begin, std::size_t end) {
+            std::size_t error_lo = 0;
+            std::size_t error_hi = 0;
+            for (std::size_t i = begin; i != end; ++i) {
+                if (i != begin and *(first + i) == *(first + i - 1)) continue; // only first occurrences are bounded
+                std::size_t pred = base_type::predict(*(first + i), segment_id);
+                if (pred > i) { // overestimation
+                    error_lo = std::max(error_lo, pred - i);
+                } else { // underestimation
+                    error_hi = std::max(error_hi, i - pred);
+                }
             }
-        }
+            errors[2 * segment_id] = error_lo;
+            errors[2 * segment_id + 1] = error_hi;
+        });
+
+        errors_.assign(base_type::l2_, errors);
     }
 
     /**
@@ -419,20 +1604,133 @@ class RmiLInd : public Rmi<Key, Layer1, Layer2>
      * @param key to search for
      * @return position estimate and search bounds
      */
-    Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        bounds err = errors_[segment_id];
-        std::size_t lo = pred > err.lo ? pred - err.lo : 0;
-        std::size_t hi = std::min(pred + err.hi + 1, base_type::n_keys_);
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return search_bounds(base_type::predict(key, segment_id), segment_id);
+    }
+
+    /**
+     * Returns search bounds around the position estimate @p pred of a key in segment @p segment_id.
+     * @param pred position estimate of the key
+     * @param segment_id of the key
+     * @return position estimate and search bounds
+     */
+    Approx search_bounds(const std::size_t pred, const std::size_t segment_id) const {
+        std::size_t err_lo = errors_.get(base_type::l2_, segment_id, 0);
+        std::size_t err_hi = errors_.get(base_type::l2_, segment_id, 1);
+        std::size_t lo = pred > err_lo ? pred - err_lo : 0;
+        std::size_t hi = std::min(pred + err_hi + 1, base_type::n_keys_);
         return {pred, lo, hi};
     }
 
+    /**
+     * Prefetches the layer2 model and the error bounds of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const {
+        base_type::prefetch_segment(segment_id);
+        errors_.prefetch(base_type::l2_, segment_id);
+    }
+
+    /**
+     * Writes position estimates and search bounds for @p n keys to @p out. Lookups are interleaved in groups of
+     * #batch_size keys so that the cache misses of different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param out array to write the position estimates and search bounds to
+     */
+    void search_batch(const key_type *keys, const std::size_t n, Approx *out) const {
+        base_type::search_batch_impl(*this, keys, n, out);
+    }
+
+    /**
+     * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each
+     * of the @p n keys to @p out. Lookups are interleaved in groups of #batch_size keys so that the cache misses of
+     * different keys overlap.
+     * @param keys array of keys to search for
+     * @param n number of keys
+     * @param data iterator to the first of the keys the index was built on
+     * @param search used for correcting prediction errors
+     * @param out array to write the positions to
+     */
+    template<typename RandomIt, typename Search>
+    void lower_bound_batch(const key_type *keys, const std::size_t n, RandomIt data, Search search,
+                           std::size_t *out) const {
+        base_type::lower_bound_batch_impl(*this, keys, n, data, search, out);
+    }
+
+    /**
+     * Writes the index to the file @p filename.
+     * @param filename name of the file to write to
+     */
+    void save(const std::string &filename) const {
+        Writer out(filename);
+        base_type::save_layers(out, bounds_id);
+        errors_.save(out);
+    }
+
+    /**
+     * Loads an index from the file @p filename written by #save(). The file is mapped into memory and the layer2
+     * models and error bounds are used in place without copying.
+     * @param filename name of the file to read from
+     * @return the index
+     */
+    static RmiLInd load(const std::string &filename) {
+        Reader in(filename);
+        return RmiLInd(in);
+    }
+
+    /**
+     * Returns the lower error bound of segment @p segment_id.
+     * @param segment_id of the segment
+     * @return the lower error bound of the segment
+     */
+    std::size_t error_lo(const std::size_t segment_id) const { return errors_.get(base_type::l2_, segment_id, 0); }
+
+    /**
+     * Returns the upper error bound of segment @p segment_id.
+     * @param segment_id of the segment
+     * @return the upper error bound of the segment
+     */
+    std::size_t error_hi(const std::size_t segment_id) const { return errors_.get(base_type::l2_, segment_id, 1); }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size_in_bytes(); }
+
+    protected:
+    template<typename Index> friend class RmiBuilder;
+
+    /// Identifies local individual bounds and their layout in index files.
+    static constexpr std::uint32_t bounds_id = 4 | Layout::id << 8;
+
+    /**
+     * Sets the lower and upper error bounds of each segment.
+     * @param errors_lo, errors_hi the largest over- and underestimation of each segment
+     */
+    void assign_bounds(const std::vector<std::size_t> &errors_lo, const std::vector<std::size_t> &errors_hi) {
+        std::vector<std::size_t> errors(2 * errors_lo.size());
+        for (std::size_t i = 0; i != errors_lo.size(); ++i) {
+            errors[2 * i] = errors_lo[i];
+            errors[2 * i + 1] = errors_hi[i];
+        }
+        errors_.assign(base_type::l2_, errors);
+    }
+
+    /**
+     * Loads an index from @p in.
+     * @param in reader to read from
+     */
+    explicit RmiLInd(Reader &in) : base_type(in, bounds_id) { errors_.load(in, base_type::l2_); }
 };
 
 } // namespace rmi
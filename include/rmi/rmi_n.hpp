@@ -0,0 +1,553 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/compact_vector.hpp"
+
+
+namespace rmi {
+
+/**
+ * A recursive model index (RMI) with an arbitrary number of layers. The first layer consists of a single model, each
+ * model of layer i predicts the model of layer i+1 that is responsible for a key, and the models of the last layer
+ * predict the position of the key.
+ *
+ * Note that this is the base class which does not provide error bounds.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Layers the types of the models used in each layer, starting with the first layer
+ */
+template<typename Key, typename... Layers>
+class RmiN
+{
+    static_assert(sizeof...(Layers) >= 2, "an RMI requires at least two layers");
+
+    using key_type = Key;
+
+    public:
+    static constexpr std::size_t n_layers = sizeof...(Layers); ///< The number of layers.
+
+    protected:
+    template<std::size_t I>
+    using layer_type = std::tuple_element_t<I, std::tuple<Layers...>>; ///< The type of the models used in layer I.
+
+    std::size_t n_keys_;                             ///< The number of keys the index was built on.
+    std::array<std::size_t, n_layers> layer_sizes_; ///< The number of models per layer, starting with the first layer.
+    std::tuple<std::vector<Layers>...> layers_;      ///< The models of each layer.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiN() = default;
+
+    /**
+     * Builds the index on the sorted @p keys with @p layer_sizes models in layers 2 to n.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    RmiN(const std::vector<key_type> &keys, const std::array<std::size_t, n_layers - 1> &layer_sizes)
+        : RmiN(keys.begin(), keys.end(), layer_sizes) { }
+
+    /**
+     * Builds the index on the sorted keys in the range [first, last) with @p layer_sizes models in layers 2 to n.
+     *
+     * The layers are trained top-down. The models of a layer are trained on the keys that the layers above assign to
+     * them, scaled to the number of models in the next layer. Like for two-layer RMIs, models without keys are trained
+     * on the last key assigned to a preceding model.
+     *
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    template<typename RandomIt>
+    RmiN(RandomIt first, RandomIt last, const std::array<std::size_t, n_layers - 1> &layer_sizes)
+        : n_keys_(std::distance(first, last))
+    {
+        layer_sizes_[0] = 1;
+        std::copy(layer_sizes.begin(), layer_sizes.end(), layer_sizes_.begin() + 1);
+        train_layers(first, std::make_index_sequence<n_layers>{});
+    }
+
+    /**
+     * Returns the id of the segment, i.e., the model in the last layer, @p key belongs to.
+     * @param key to get segment id for
+     * @return segment id of the given key
+     */
+    std::size_t get_segment_id(const key_type key) const { return route<n_layers - 1>(key); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const { return search(key, get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        return {predict(key, segment_id), 0, n_keys_};
+    }
+
+    /**
+     * Prefetches the model of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const {
+        __builtin_prefetch(&std::get<n_layers - 1>(layers_)[segment_id]);
+    }
+
+    /**
+     * Returns the number of keys the index was built on.
+     * @return the number of keys the index was built on
+     */
+    std::size_t n_keys() const { return n_keys_; }
+
+    /**
+     * Returns the number of models in layer @p i, starting with 0 for the first layer.
+     * @param i the layer
+     * @return the number of models in the layer
+     */
+    std::size_t layer_size(const std::size_t i) const { return layer_sizes_[i]; }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() {
+        return models_size_in_bytes(std::make_index_sequence<n_layers>{}) + sizeof(n_keys_) + sizeof(layer_sizes_);
+    }
+
+    protected:
+    /**
+     * Returns the id of the model in layer @p I that is responsible for @p key.
+     * @tparam I the layer
+     * @param key to route
+     * @return model id in layer @p I
+     */
+    template<std::size_t I>
+    std::size_t route(const key_type key) const {
+        if constexpr (I == 0) {
+            return 0;
+        } else {
+            std::size_t model_id = route<I - 1>(key);
+            return clamp_prediction(std::get<I - 1>(layers_)[model_id].predict(key), layer_sizes_[I] - 1);
+        }
+    }
+
+    /**
+     * Returns the position estimate of the model of segment @p segment_id for @p key clamped to the valid range of
+     * positions.
+     * @param key to predict the position of
+     * @param segment_id of the given key
+     * @return position estimate
+     */
+    std::size_t predict(const key_type key, const std::size_t segment_id) const {
+        return clamp_prediction(std::get<n_layers - 1>(layers_)[segment_id].predict(key), n_keys_ - 1);
+    }
+
+    /**
+     * Trains all layers in order.
+     * @param first iterator to the first of the keys the index is built on
+     */
+    template<typename RandomIt, std::size_t... Is>
+    void train_layers(RandomIt first, std::index_sequence<Is...>) {
+        (train_layer<Is>(first), ...);
+    }
+
+    /**
+     * Trains the models of layer @p I on the keys assigned to them by the layers above.
+     * @tparam I the layer
+     * @param first iterator to the first of the keys the index is built on
+     */
+    template<std::size_t I, typename RandomIt>
+    void train_layer(RandomIt first) {
+        using model_type = layer_type<I>;
+        auto &models = std::get<I>(layers_);
+        models.resize(layer_sizes_[I]);
+
+        // Inner layers predict model ids of the next layer, the last layer predicts positions.
+        double compression_factor = 1.;
+        if constexpr (I + 1 < n_layers) compression_factor = static_cast<double>(layer_sizes_[I + 1]) / n_keys_;
+
+        if constexpr (I == 0) {
+            models[0] = model_type(first, first + n_keys_, 0, compression_factor);
+        } else {
+            std::size_t segment_start = 0;
+            std::size_t segment_id = 0;
+            // Assign each key to its model.
+            for (std::size_t i = 0; i != n_keys_; ++i) {
+                auto pos = first + i;
+                std::size_t pred_segment_id = route<I>(*pos);
+                // If a key is assigned to a new model, all models must be trained up to the new model.
+                if (pred_segment_id > segment_id) {
+                    models[segment_id] = model_type(first + segment_start, pos, segment_start, compression_factor);
+                    for (std::size_t j = segment_id + 1; j < pred_segment_id; ++j) {
+                        if (i == 0)
+                            models[j] = model_type(pos, pos + 1, 0, compression_factor); // train on first key
+                        else
+                            models[j] = model_type(pos - 1, pos, i - 1, compression_factor); // train on last key
+                    }
+                    segment_id = pred_segment_id;
+                    segment_start = i;
+                }
+            }
+            // Train remaining models.
+            auto last = first + n_keys_;
+            models[segment_id] = model_type(first + segment_start, last, segment_start, compression_factor);
+            for (std::size_t j = segment_id + 1; j < layer_sizes_[I]; ++j) {
+                models[j] = model_type(last - 1, last, n_keys_ - 1, compression_factor); // train on last key
+            }
+        }
+    }
+
+    /**
+     * Computes the position estimate of each key and calls @p visit with its segment id, its position, and the
+     * estimate. Since the assignment of keys to segments is not necessarily monotonic for more than two layers,
+     * segments are determined by routing each key through all layers.
+     * @param first iterator to the first of the keys the index is built on
+     * @param visit function called as visit(segment_id, pos, pred) for each key
+     */
+    template<typename RandomIt, typename Visit>
+    void visit_predictions(RandomIt first, Visit visit) const {
+        for (std::size_t i = 0; i != n_keys_; ++i) {
+            key_type key = *(first + i);
+            std::size_t segment_id = get_segment_id(key);
+            visit(segment_id, i, predict(key, segment_id));
+        }
+    }
+
+    /**
+     * Returns the size of the models of all layers in bytes.
+     * @return size of the models in bytes
+     */
+    template<std::size_t... Is>
+    std::size_t models_size_in_bytes(std::index_sequence<Is...>) {
+        return ((layer_sizes_[Is] * std::get<Is>(layers_).front().size_in_bytes()) + ...);
+    }
+};
+
+
+/**
+ * Recursive model index with an arbitrary number of layers and global absolute bounds.
+ */
+template<typename Key, typename... Layers>
+class RmiNGAbs : public RmiN<Key, Layers...>
+{
+    using base_type = RmiN<Key, Layers...>;
+    using key_type = Key;
+
+    protected:
+    std::size_t error_; ///< The error bound of the models in the last layer.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiNGAbs() = default;
+
+    /**
+     * Builds the index on the sorted @p keys with @p layer_sizes models in layers 2 to n.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    RmiNGAbs(const std::vector<key_type> &keys, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : RmiNGAbs(keys.begin(), keys.end(), layer_sizes) { }
+
+    /**
+     * Builds the index on the sorted keys in the range [first, last) with @p layer_sizes models in layers 2 to n.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    template<typename RandomIt>
+    RmiNGAbs(RandomIt first, RandomIt last, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : base_type(first, last, layer_sizes)
+    {
+        // Compute global absolute errror bounds.
+        error_ = 0;
+        base_type::visit_predictions(first, [&](std::size_t, std::size_t i, std::size_t pred) {
+            error_ = std::max(error_, pred > i ? pred - i : i - pred);
+        });
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        std::size_t pred = base_type::predict(key, segment_id);
+        std::size_t lo = pred > error_ ? pred - error_ : 0;
+        std::size_t hi = std::min(pred + error_ + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_); }
+};
+
+
+/**
+ * Recursive model index with an arbitrary number of layers and global individual bounds.
+ */
+template<typename Key, typename... Layers>
+class RmiNGInd : public RmiN<Key, Layers...>
+{
+    using base_type = RmiN<Key, Layers...>;
+    using key_type = Key;
+
+    protected:
+    std::size_t error_lo_; ///< The lower error bound of the models in the last layer.
+    std::size_t error_hi_; ///< The upper error bound of the models in the last layer.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiNGInd() = default;
+
+    /**
+     * Builds the index on the sorted @p keys with @p layer_sizes models in layers 2 to n.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    RmiNGInd(const std::vector<key_type> &keys, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : RmiNGInd(keys.begin(), keys.end(), layer_sizes) { }
+
+    /**
+     * Builds the index on the sorted keys in the range [first, last) with @p layer_sizes models in layers 2 to n.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    template<typename RandomIt>
+    RmiNGInd(RandomIt first, RandomIt last, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : base_type(first, last, layer_sizes)
+    {
+        // Compute global individual errror bounds.
+        error_lo_ = 0;
+        error_hi_ = 0;
+        base_type::visit_predictions(first, [&](std::size_t, std::size_t i, std::size_t pred) {
+            if (pred > i) { // overestimation
+                error_lo_ = std::max(error_lo_, pred - i);
+            } else { // underestimation
+                error_hi_ = std::max(error_hi_, i - pred);
+            }
+        });
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        std::size_t pred = base_type::predict(key, segment_id);
+        std::size_t lo = pred > error_lo_ ? pred - error_lo_ : 0;
+        std::size_t hi = std::min(pred + error_hi_ + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_lo_) + sizeof(error_hi_); }
+};
+
+
+/**
+ * Recursive model index with an arbitrary number of layers and local absolute bounds.
+ */
+template<typename Key, typename... Layers>
+class RmiNLAbs : public RmiN<Key, Layers...>
+{
+    using base_type = RmiN<Key, Layers...>;
+    using key_type = Key;
+
+    protected:
+    CompactVector errors_; ///< The error bounds of the models in the last layer.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiNLAbs() = default;
+
+    /**
+     * Builds the index on the sorted @p keys with @p layer_sizes models in layers 2 to n.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    RmiNLAbs(const std::vector<key_type> &keys, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : RmiNLAbs(keys.begin(), keys.end(), layer_sizes) { }
+
+    /**
+     * Builds the index on the sorted keys in the range [first, last) with @p layer_sizes models in layers 2 to n.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    template<typename RandomIt>
+    RmiNLAbs(RandomIt first, RandomIt last, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : base_type(first, last, layer_sizes)
+    {
+        // Compute local absolute errror bounds.
+        std::vector<std::size_t> errors(layer_sizes.back(), 0);
+        base_type::visit_predictions(first, [&](std::size_t segment_id, std::size_t i, std::size_t pred) {
+            errors[segment_id] = std::max(errors[segment_id], pred > i ? pred - i : i - pred);
+        });
+        errors_ = CompactVector(errors);
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        std::size_t pred = base_type::predict(key, segment_id);
+        std::size_t err = errors_[segment_id];
+        std::size_t lo = pred > err ? pred - err : 0;
+        std::size_t hi = std::min(pred + err + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
+
+    /**
+     * Prefetches the model and the error bounds of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const {
+        base_type::prefetch_segment(segment_id);
+        __builtin_prefetch(errors_.address(segment_id));
+    }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size_in_bytes(); }
+};
+
+
+/**
+ * Recursive model index with an arbitrary number of layers and local individual bounds.
+ */
+template<typename Key, typename... Layers>
+class RmiNLInd : public RmiN<Key, Layers...>
+{
+    using base_type = RmiN<Key, Layers...>;
+    using key_type = Key;
+
+    protected:
+    CompactVector errors_; ///< The lower and upper error bounds of the models in the last layer, stored interleaved.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiNLInd() = default;
+
+    /**
+     * Builds the index on the sorted @p keys with @p layer_sizes models in layers 2 to n.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    RmiNLInd(const std::vector<key_type> &keys, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : RmiNLInd(keys.begin(), keys.end(), layer_sizes) { }
+
+    /**
+     * Builds the index on the sorted keys in the range [first, last) with @p layer_sizes models in layers 2 to n.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer_sizes the number of models in each layer, starting with the second layer
+     */
+    template<typename RandomIt>
+    RmiNLInd(RandomIt first, RandomIt last, const std::array<std::size_t, base_type::n_layers - 1> &layer_sizes)
+        : base_type(first, last, layer_sizes)
+    {
+        // Compute local individual errror bounds.
+        std::vector<std::size_t> errors(2 * layer_sizes.back(), 0);
+        base_type::visit_predictions(first, [&](std::size_t segment_id, std::size_t i, std::size_t pred) {
+            if (pred > i) { // overestimation
+                std::size_t &lo = errors[2 * segment_id];
+                lo = std::max(lo, pred - i);
+            } else { // underestimation
+                std::size_t &hi = errors[2 * segment_id + 1];
+                hi = std::max(hi, i - pred);
+            }
+        });
+        errors_ = CompactVector(errors);
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const { return search(key, base_type::get_segment_id(key)); }
+
+    /**
+     * Returns a position estimate and search bounds for a given key whose segment id is already known.
+     * @param key to search for
+     * @param segment_id of the given key
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key, const std::size_t segment_id) const {
+        std::size_t pred = base_type::predict(key, segment_id);
+        std::size_t err_lo = errors_[2 * segment_id];
+        std::size_t err_hi = errors_[2 * segment_id + 1];
+        std::size_t lo = pred > err_lo ? pred - err_lo : 0;
+        std::size_t hi = std::min(pred + err_hi + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
+
+    /**
+     * Prefetches the model and the error bounds of segment @p segment_id.
+     * @param segment_id of the segment to prefetch
+     */
+    void prefetch_segment(const std::size_t segment_id) const {
+        base_type::prefetch_segment(segment_id);
+        __builtin_prefetch(errors_.address(2 * segment_id));
+    }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size_in_bytes(); }
+};
+
+} // namespace rmi
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/string_array.hpp"
+
+
+namespace rmi {
+
+/**
+ * Order-preserving map from strings to 64-bit integers. Sorted string keys often share a long common prefix, e.g., the
+ * scheme and host of URLs, which carries no information to distinguish them. The map strips the common prefix of all
+ * keys and interprets the next eight bytes as a big-endian integer, padding shorter keys with zero bytes. Strings
+ * that do not start with the common prefix are mapped to zero or the maximum value depending on their order relative
+ * to the prefix.
+ *
+ * The map is monotonic but not injective, i.e., `a < b` implies `encode(a) <= encode(b)`, and keys that share the
+ * first eight bytes after the common prefix are mapped to the same integer.
+ */
+class StringPrefix
+{
+    private:
+    std::string common_; ///< The common prefix of all keys.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    StringPrefix() = default;
+
+    /**
+     * Computes the common prefix of sorted keys from their first key @p first and their last key @p last.
+     * @param first the smallest key
+     * @param last the largest key
+     */
+    StringPrefix(const std::string_view first, const std::string_view last) {
+        auto n = std::min(first.size(), last.size());
+        auto mismatch = std::mismatch(first.begin(), first.begin() + n, last.begin());
+        common_.assign(first.begin(), mismatch.first);
+    }
+
+    /**
+     * Returns the integer @p key is mapped to.
+     * @param key the key to map
+     * @return the integer of the key
+     */
+    std::uint64_t encode(const std::string_view key) const {
+        auto head = key.substr(0, common_.size());
+        if (head != common_) return head < common_ ? 0 : ~std::uint64_t(0);
+        char bytes[sizeof(std::uint64_t)] = { };
+        std::memcpy(bytes, key.data() + common_.size(), std::min(key.size() - common_.size(), sizeof(bytes)));
+        std::uint64_t prefix;
+        std::memcpy(&prefix, bytes, sizeof(prefix));
+        return __builtin_bswap64(prefix); // big-endian, so that integer order matches byte-wise string order
+    }
+
+    /**
+     * Returns the common prefix that is stripped from keys.
+     * @return the common prefix
+     */
+    const std::string & common_prefix() const { return common_; }
+
+    /**
+     * Returns the size of the map in bytes.
+     * @return map size in bytes
+     */
+    std::size_t size_in_bytes() const { return common_.size() + sizeof(std::size_t); }
+};
+
+
+/**
+ * A recursive model index over variable-length string keys. The keys are mapped to 64-bit integers by a StringPrefix
+ * and an index of type @p Rmi, e.g., `RmiLAbs<uint64_t, LinearSpline, LinearRegression>`, is built on the integers.
+ * Lookups map the key, let the index predict a position and search bounds, and correct the prediction by a last-mile
+ * search over the keys packed into a StringArray.
+ *
+ * Keys that share the first eight bytes after the common prefix are mapped to the same integer and thus to the same
+ * prediction. The index treats them as duplicates, i.e., its error bounds only cover the first key of each run of
+ * keys with equal prefix, and lookups of later keys of a run continue right of the bounds by exponential search. Long
+ * runs, e.g., from a dataset of composite keys with a low-entropy leading field, degrade lookups towards a search
+ * within the run.
+ *
+ * @tparam Rmi the type of the index built on the mapped keys, must have `uint64_t` keys
+ */
+template<typename Rmi>
+class StringRmi
+{
+    using rmi_type = Rmi;
+
+    protected:
+    StringPrefix prefix_; ///< The map from keys to integers.
+    rmi_type rmi_;        ///< The index built on the mapped keys.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    StringRmi() = default;
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
+     * @param keys array of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param n_threads the number of threads used for training layer2
+     */
+    StringRmi(const StringArray &keys, const std::size_t layer2_size, const std::size_t n_threads = 1)
+        : prefix_(keys.empty() ? StringPrefix() : StringPrefix(keys[0], keys[keys.size() - 1]))
+        , rmi_(encode(keys, prefix_), layer2_size, n_threads) { }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const std::string_view key) const { return rmi_.search(prefix_.encode(key)); }
+
+    /**
+     * Returns the position of the first of the @p keys the index was built on that is not less than @p key. Keys may
+     * lie outside the search bounds of the index, e.g., if no indexed key has the same mapped integer or if the key
+     * follows the first key of a run with the same mapped integer, in which case the search continues on the
+     * respective side of the bounds.
+     * @param keys array of sorted keys the index was built on
+     * @param key to search for
+     * @param search used for correcting prediction errors
+     * @return the position of the first key that is not less than @p key
+     */
+    template<typename Search>
+    std::size_t lower_bound(const StringArray &keys, const std::string_view key, Search search) const {
+        auto range = this->search(key);
+        auto first = keys.begin();
+        std::size_t pos = search(first + range.lo, first + range.hi, first + range.pos, key) - first;
+        if (pos == range.lo and pos != 0 and keys[pos - 1] >= key)
+            pos = std::lower_bound(first, first + pos, key) - first; // continue left of the bounds
+        else if (pos == range.hi and pos != keys.size() and keys[pos] < key) // continue right of the bounds
+            pos = ExponentialSearch()(first + pos, keys.end(), first + pos, key) - first;
+        return pos;
+    }
+
+    /**
+     * Returns the map from keys to integers.
+     * @return the map
+     */
+    const StringPrefix & prefix() const { return prefix_; }
+
+    /**
+     * Returns the index built on the mapped keys.
+     * @return the index
+     */
+    const rmi_type & index() const { return rmi_; }
+
+    /**
+     * Returns the number of keys the index was built on.
+     * @return the number of keys the index was built on
+     */
+    std::size_t n_keys() const { return rmi_.n_keys(); }
+
+    /**
+     * Returns the number of models in layer2.
+     * @return the number of models in layer2
+     */
+    std::size_t layer2_size() const { return rmi_.layer2_size(); }
+
+    /**
+     * Returns the size of the index in bytes, excluding the keys.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() { return prefix_.size_in_bytes() + rmi_.size_in_bytes(); }
+
+    private:
+    /**
+     * Maps the @p keys to integers by @p prefix.
+     * @param keys the keys to map
+     * @param prefix the map
+     * @return the integers of the keys
+     */
+    static std::vector<std::uint64_t> encode(const StringArray &keys, const StringPrefix &prefix) {
+        std::vector<std::uint64_t> encoded;
+        encoded.reserve(keys.size());
+        for (auto key : keys)
+            encoded.push_back(prefix.encode(key));
+        return encoded;
+    }
+};
+
+} // namespace rmi
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rmi/cost_model.hpp"
+#include "rmi/models.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Tuner
+ *====================================================================================================================*/
+
+/**
+ * Name of the models considered by #tune().
+ * @tparam Model the model type
+ */
+template<typename Model>
+struct tune_traits;
+
+template<>
+struct tune_traits<LinearSpline>
+{
+    static constexpr const char *name = "linear_spline";
+};
+
+template<>
+struct tune_traits<LinearRegression>
+{
+    static constexpr const char *name = "linear_regression";
+};
+
+template<>
+struct tune_traits<CubicSpline>
+{
+    static constexpr const char *name = "cubic_spline";
+};
+
+template<typename X>
+struct tune_traits<Radix<X>>
+{
+    static constexpr const char *name = "radix";
+};
+
+/**
+ * RMI configuration chosen by #tune(). Model types, bounds, and search algorithms are named as in the experiments,
+ * e.g., `linear_spline`, `labs`, and `model_biased_binary`.
+ */
+struct TunedConfig {
+    std::string layer1;                ///< The model type of layer1.
+    std::string layer2;                ///< The model type of layer2.
+    std::string bounds;                ///< The error bounds, either none, labs, or lind.
+    std::string search;                ///< The search algorithm for correcting prediction errors.
+    std::size_t layer2_size = 0;       ///< The number of models in layer2.
+    std::size_t size_in_bytes = 0;     ///< The size of the index in bytes, assuming 8-byte error bounds.
+    double mean_log2_error = 0.;       ///< The mean log2 error of the sampled lookups.
+    double lookup_ns = std::numeric_limits<double>::infinity(); ///< The predicted lookup time.
+};
+
+/**
+ * Position estimate, true position, and local error bounds of a sampled lookup.
+ */
+struct SampledLookup {
+    std::size_t pred;     ///< The position estimate of the layer2 model.
+    std::size_t pos;      ///< The position of the first key not less than the looked up key.
+    std::size_t error_lo; ///< The lower error bound of the segment.
+    std::size_t error_hi; ///< The upper error bound of the segment.
+};
+
+/**
+ * Estimates the prediction errors of an RMI with layer1 model @p l1 and @p layer2_size models on the sorted @p keys
+ * for the sorted @p sample of lookup keys. Only the layer2 models of segments hit by the sample are trained and their
+ * local error bounds computed. Segments of more than @p max_segment_keys keys are represented by a strided sample of
+ * their keys, which slightly underestimates their error bounds but bounds the work per segment.
+ * @tparam Layer2 the type of the models used in layer2
+ * @param keys vector of sorted keys
+ * @param sample vector of sorted lookup keys
+ * @param l1 the layer1 model trained like by the RMI
+ * @param layer2_size the number of models in layer2
+ * @param max_segment_keys the maximum number of keys per segment used for training and computing error bounds
+ * @return the sampled lookups
+ */
+template<typename Layer2, typename Layer1, typename Key>
+std::vector<SampledLookup> sample_lookups(const std::vector<Key> &keys, const std::vector<Key> &sample,
+                                          const Layer1 &l1, const std::size_t layer2_size,
+                                          const std::size_t max_segment_keys = 1024)
+{
+    const std::size_t n_keys = keys.size();
+    auto segment_id = [&](const Key key) { return clamp_prediction(l1.predict(key), layer2_size - 1); };
+
+    std::vector<SampledLookup> lookups;
+    lookups.reserve(sample.size());
+    std::vector<Key> distinct;
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i != sample.size(); ) {
+        // Find the keys of the segment, segment ids are monotonic in the keys.
+        std::size_t id = segment_id(sample[i]);
+        auto first = std::partition_point(keys.begin(), keys.end(), [&](const Key k) { return segment_id(k) < id; });
+        auto last = std::partition_point(first, keys.end(), [&](const Key k) { return segment_id(k) <= id; });
+        std::size_t begin = std::distance(keys.begin(), first);
+        std::size_t end = std::distance(keys.begin(), last);
+
+        // Collect the first occurrences of the (sampled) keys of the segment.
+        distinct.clear();
+        positions.clear();
+        if (begin == end and begin != 0) { // empty segments are trained on the last key in previous segment
+            distinct.push_back(keys[begin - 1]);
+            positions.push_back(begin - 1);
+        }
+        std::size_t stride = (end - begin + max_segment_keys - 1) / max_segment_keys;
+        for (std::size_t j = begin; j < end; ) {
+            distinct.push_back(keys[j]);
+            positions.push_back(j);
+            // Advance to the first occurrence of the key a stride ahead, or past the run of the current key.
+            auto next = keys.begin() + std::min(j + stride, end - 1);
+            auto pos = *next == keys[j] ? std::upper_bound(keys.begin() + j, last, keys[j])
+                                        : std::lower_bound(keys.begin() + j + 1, next + 1, *next);
+            j = std::distance(keys.begin(), pos);
+        }
+        if (begin != end and distinct.back() != keys[end - 1]) { // always include the last key of the segment
+            distinct.push_back(keys[end - 1]);
+            positions.push_back(std::distance(keys.begin(), std::lower_bound(first, last, keys[end - 1])));
+        }
+
+        // Train the layer2 model like Rmi::train_layer2() and compute local error bounds like RmiLInd.
+        Layer2 l2(distinct.begin(), distinct.end(), positions.begin(), positions.end(), 1.);
+        std::size_t error_lo = 0;
+        std::size_t error_hi = 0;
+        for (std::size_t j = 0; j != distinct.size() and begin != end; ++j) {
+            std::size_t pred = clamp_prediction(l2.predict(distinct[j]), n_keys - 1);
+            if (pred > positions[j]) error_lo = std::max(error_lo, pred - positions[j]);
+            else error_hi = std::max(error_hi, positions[j] - pred);
+        }
+
+        // Record lookups of the segment.
+        for (; i != sample.size() and segment_id(sample[i]) == id; ++i) {
+            std::size_t pred = clamp_prediction(l2.predict(sample[i]), n_keys - 1);
+            std::size_t pos = std::distance(keys.begin(), std::lower_bound(keys.begin(), keys.end(), sample[i]));
+            lookups.push_back({pred, pos, error_lo, error_hi});
+        }
+    }
+    return lookups;
+}
+
+/**
+ * Predicts the lookup times of all error bounds and search algorithms considered by #tune() for RMIs with
+ * @p Layer1 and @p Layer2 models and updates @p best if one of them is faster. For each type of error bounds, the
+ * largest layer2 size that fits into @p budget and up to @p n_halvings halvings of it are evaluated, because smaller
+ * indexes may fit into the cache. Layer2 sizes below 2 are not evaluated, since a single segment leaves layer1 nothing
+ * to predict, e.g., Radix would need a prefix of zero bits.
+ * @tparam Layer1 the type of the model used in layer1
+ * @tparam Layer2 the type of the models used in layer2
+ * @param keys vector of sorted keys
+ * @param sample vector of sorted lookup keys
+ * @param budget the maximum size of the index in bytes
+ * @param cost the cost model
+ * @param n_halvings the number of halvings of the largest layer2 size
+ * @param layer1_models the layer1 models trained so far by layer2 size
+ * @param best the fastest configuration found so far
+ */
+template<typename Layer1, typename Layer2, typename Key>
+void tune_models(const std::vector<Key> &keys, const std::vector<Key> &sample, const std::size_t budget,
+                 const CostModel &cost, const std::size_t n_halvings, std::map<std::size_t, Layer1> &layer1_models,
+                 TunedConfig &best)
+{
+    constexpr const char *bounds_names[] = {"none", "labs", "lind"};
+    const std::size_t n_keys = keys.size();
+    const std::size_t keys_bytes = n_keys * sizeof(Key);
+    const std::size_t fixed_bytes = Layer1().size_in_bytes() + 2 * sizeof(std::size_t); // layer1, n_keys, layer2_size
+    if (budget <= fixed_bytes) return;
+
+    for (std::size_t b = 0; b != 3; ++b) {
+        std::size_t max_size = (budget - fixed_bytes) / (Layer2().size_in_bytes() + b * sizeof(std::size_t));
+        for (std::size_t h = 0; h <= n_halvings and (max_size >> h) >= 2; ++h) {
+            std::size_t layer2_size = max_size >> h;
+            std::size_t size = fixed_bytes + layer2_size * (Layer2().size_in_bytes() + b * sizeof(std::size_t));
+
+            // Train layer1 with compression like the RMI, unless it was trained for another layer2 model type.
+            auto it = layer1_models.find(layer2_size);
+            if (it == layer1_models.end()) {
+                Layer1 l1(keys.begin(), keys.end(), 0, static_cast<double>(layer2_size) / n_keys);
+                it = layer1_models.emplace(layer2_size, l1).first;
+            }
+
+            // Compute the error histogram of the sampled lookups.
+            auto lookups = sample_lookups<Layer2>(keys, sample, it->second, layer2_size);
+            ErrorHistogram hist;
+            double log2_error = 0.;
+            for (auto &l : lookups) {
+                std::size_t lo = 0;
+                std::size_t hi = n_keys;
+                if (b == 1) {
+                    std::size_t error = std::max(l.error_lo, l.error_hi);
+                    lo = l.pred > error ? l.pred - error : 0;
+                    hi = std::min(l.pred + error + 1, n_keys);
+                } else if (b == 2) {
+                    lo = l.pred > l.error_lo ? l.pred - l.error_lo : 0;
+                    hi = std::min(l.pred + l.error_hi + 1, n_keys);
+                }
+                hist.add(l.pred, l.pos, lo, hi);
+                log2_error += std::log2((l.pred > l.pos ? l.pred - l.pos : l.pos - l.pred) + 1.);
+            }
+
+            // Searches without bounds must be model-biased and are limited by the size of the key array.
+            for (std::string search : CostModel::searches) {
+                if (b == 0 and (search == "binary" or search == "model_biased_binary")) continue;
+                double lookup_ns = predict_lookup_ns<Layer1, Layer2>(cost, hist, bounds_names[b], search, size,
+                                                                     keys_bytes);
+                if (lookup_ns < best.lookup_ns) {
+                    best = {tune_traits<Layer1>::name, tune_traits<Layer2>::name, bounds_names[b], search,
+                            layer2_size, size, log2_error / lookups.size(), lookup_ns};
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Chooses the RMI configuration with the lowest predicted lookup time for @p workload_sample on @p keys whose size
+ * does not exceed @p budget bytes. The tuner considers LinearSpline, CubicSpline, LinearRegression, and Radix models
+ * in layer1, LinearRegression and LinearSpline models in layer2, no bounds, local absolute bounds, and local
+ * individual bounds, several sizes of layer2, as well as binary, model-biased binary, model-biased exponential, and
+ * model-biased linear search. The prediction errors of each configuration are estimated from the segments hit by the
+ * sample, and lookup times are predicted from their error histogram using @p cost, e.g., a machine profile written by
+ * the `rmi_calibrate` tool.
+ *
+ * Global bounds are not considered, since estimating them requires training all segments and they are larger than
+ * local bounds at the same size. Tuning time grows with the size of the sample, a few thousand keys usually suffice.
+ * @param keys vector of sorted keys to be indexed
+ * @param budget the maximum size of the index in bytes
+ * @param workload_sample vector of lookup keys that represents the workload
+ * @param cost the cost model used for predicting lookup times
+ * @param n_halvings the number of halvings of the largest layer2 size fitting into the budget to consider
+ * @return the configuration with the lowest predicted lookup time
+ */
+template<typename Key>
+TunedConfig tune(const std::vector<Key> &keys, const std::size_t budget, const std::vector<Key> &workload_sample,
+                 const CostModel &cost = CostModel(), const std::size_t n_halvings = 5)
+{
+    if (keys.empty() or workload_sample.empty()) {
+        std::cerr << "Error: Tuning requires keys and a non-empty workload sample." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::vector<Key> sample(workload_sample);
+    std::sort(sample.begin(), sample.end());
+
+    TunedConfig best;
+    auto tune_layer1 = [&](auto layer1_models) {
+        using layer1_type = typename decltype(layer1_models)::mapped_type;
+        tune_models<layer1_type, LinearRegression>(keys, sample, budget, cost, n_halvings, layer1_models, best);
+        tune_models<layer1_type, LinearSpline>(keys, sample, budget, cost, n_halvings, layer1_models, best);
+    };
+    tune_layer1(std::map<std::size_t, LinearSpline>());
+    tune_layer1(std::map<std::size_t, CubicSpline>());
+    tune_layer1(std::map<std::size_t, LinearRegression>());
+    tune_layer1(std::map<std::size_t, Radix<Key>>());
+
+    if (best.layer2_size == 0) {
+        std::cerr << "Error: Budget of " << budget << " bytes is too small for any RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return best;
+}
+
+} // namespace rmi
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/**
+ * An updatable two-layer recursive model index over a set of keys.
+ *
+ * Layer1 assigns each key to a segment. Each segment holds its keys in a sorted array, a layer2 model trained on them,
+ * and the local absolute error bound of the model. Inserts and deletes are not applied to the sorted array directly
+ * but buffered in a small sorted delta array per segment, deletes of existing keys as tombstones. Lookups search the
+ * sorted array within the error bounds and consult the delta only if the segment has one. Once the delta of a segment
+ * exceeds a threshold, it is merged into the segment's keys and the segment's model and error bound are retrained.
+ * All other segments, as well as layer1, are left untouched.
+ *
+ * Segments are cache-line aligned and hold the model, the error bound, and pointers to the keys and the delta, so the
+ * read path only adds a check for an empty delta to a lookup in an RMI with local absolute bounds.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Layer1 the type of the model used in layer1
+ * @tparam Layer2 the type of the models used in layer2
+ */
+template<typename Key, typename Layer1, typename Layer2>
+class UpdatableRmi
+{
+    using key_type = Key;
+    using layer1_type = Layer1;
+    using layer2_type = Layer2;
+
+    protected:
+    /**
+     * Struct to store a buffered insert or delete.
+     */
+    struct delta_entry {
+        key_type key;   ///< The inserted or deleted key.
+        bool tombstone; ///< Whether the key was deleted.
+    };
+
+    using delta_type = std::vector<delta_entry>; ///< Sorted array of buffered inserts and deletes.
+
+    /**
+     * Struct to store a segment.
+     */
+    struct alignas(64) segment {
+        layer2_type model;                 ///< The layer2 model trained on the keys of the segment.
+        std::size_t error;                 ///< The local absolute error bound of the model.
+        std::vector<key_type> keys;        ///< The sorted keys of the segment.
+        std::unique_ptr<delta_type> delta; ///< The buffered inserts and deletes, nullptr if there are none.
+    };
+
+    std::size_t n_keys_;          ///< The number of keys in the index.
+    std::size_t layer2_size_;     ///< The number of segments.
+    std::size_t delta_threshold_; ///< The delta size at which a segment is retrained.
+    layer1_type l1_;              ///< The layer1 model.
+    std::vector<segment> l2_;     ///< The segments.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    UpdatableRmi() = default;
+
+    /**
+     * Builds the index with @p layer2_size segments on the sorted @p keys. Duplicate keys are stored once.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of segments
+     * @param delta_threshold the number of buffered inserts and deletes after which a segment is retrained
+     */
+    UpdatableRmi(const std::vector<key_type> &keys, const std::size_t layer2_size,
+                 const std::size_t delta_threshold = 256)
+        : UpdatableRmi(keys.begin(), keys.end(), layer2_size, delta_threshold) { }
+
+    /**
+     * Builds the index with @p layer2_size segments on the sorted keys in the range [first, last). Duplicate keys are
+     * stored once.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of segments
+     * @param delta_threshold the number of buffered inserts and deletes after which a segment is retrained
+     */
+    template<typename RandomIt>
+    UpdatableRmi(RandomIt first, RandomIt last, const std::size_t layer2_size, const std::size_t delta_threshold = 256)
+        : n_keys_(0)
+        , layer2_size_(layer2_size)
+        , delta_threshold_(delta_threshold)
+        , l2_(layer2_size)
+    {
+        // Train layer1.
+        std::size_t n = std::distance(first, last);
+        l1_ = layer1_type(first, last, 0, static_cast<double>(layer2_size) / n); // train with compression
+
+        // Assign each key to its segment.
+        for (auto it = first; it != last; ++it) {
+            auto &keys = l2_[get_segment_id(*it)].keys;
+            if (keys.empty() or keys.back() != *it) {
+                keys.push_back(*it);
+                ++n_keys_;
+            }
+        }
+
+        // Train layer2.
+        for (auto &s : l2_)
+            train(s);
+    }
+
+    /**
+     * Returns the id of the segment @p key belongs to.
+     * @param key to get segment id for
+     * @return segment id of the given key
+     */
+    std::size_t get_segment_id(const key_type key) const {
+        return clamp_prediction(l1_.predict(key), layer2_size_ - 1);
+    }
+
+    /**
+     * Returns whether @p key is contained in the index.
+     * @param key to search for
+     * @return whether @p key is contained
+     */
+    bool contains(const key_type key) const {
+        const segment &s = l2_[get_segment_id(key)];
+        if (s.delta) {
+            auto it = find(*s.delta, key);
+            if (it != s.delta->end()) return not it->tombstone;
+        }
+        return contains(s, key);
+    }
+
+    /**
+     * Inserts @p key into the index if it is not contained yet.
+     * @param key to insert
+     * @return whether @p key was inserted
+     */
+    bool insert(const key_type key) {
+        segment &s = l2_[get_segment_id(key)];
+        if (s.delta) {
+            auto it = find(*s.delta, key);
+            if (it != s.delta->end()) {
+                if (not it->tombstone) return false; // already inserted
+                s.delta->erase(it); // revert deletion
+                ++n_keys_;
+                return true;
+            }
+        }
+        if (contains(s, key)) return false;
+        buffer(s, {key, false});
+        ++n_keys_;
+        return true;
+    }
+
+    /**
+     * Removes @p key from the index if it is contained.
+     * @param key to remove
+     * @return whether @p key was removed
+     */
+    bool erase(const key_type key) {
+        segment &s = l2_[get_segment_id(key)];
+        if (s.delta) {
+            auto it = find(*s.delta, key);
+            if (it != s.delta->end()) {
+                if (it->tombstone) return false; // already deleted
+                s.delta->erase(it); // revert insertion
+                --n_keys_;
+                return true;
+            }
+        }
+        if (not contains(s, key)) return false;
+        buffer(s, {key, true});
+        --n_keys_;
+        return true;
+    }
+
+    /**
+     * Returns the number of keys in the index.
+     * @return the number of keys in the index
+     */
+    std::size_t size() const { return n_keys_; }
+
+    /**
+     * Returns the number of segments.
+     * @return the number of segments
+     */
+    std::size_t layer2_size() const { return layer2_size_; }
+
+    /**
+     * Returns the size of the index in bytes, excluding the keys and the deltas.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() {
+        return l1_.size_in_bytes() + layer2_size_ * sizeof(segment) + sizeof(n_keys_) + sizeof(layer2_size_)
+            + sizeof(delta_threshold_);
+    }
+
+    protected:
+    /**
+     * Returns whether @p key is contained in the sorted keys of segment @p s, ignoring its delta.
+     * @param s segment to search
+     * @param key to search for
+     * @return whether @p key is contained in the sorted keys
+     */
+    static bool contains(const segment &s, const key_type key) {
+        std::size_t n = s.keys.size();
+        if (n == 0) return false;
+        std::size_t pred = clamp_prediction(s.model.predict(key), n - 1);
+        std::size_t lo = pred > s.error ? pred - s.error : 0;
+        std::size_t hi = std::min(pred + s.error + 1, n);
+        auto it = std::lower_bound(s.keys.begin() + lo, s.keys.begin() + hi, key);
+        return it != s.keys.begin() + hi and *it == key;
+    }
+
+    /**
+     * Returns an iterator to the entry of @p key in @p delta or the end of @p delta if there is none.
+     * @param delta to search
+     * @param key to search for
+     * @return iterator to the entry of @p key
+     */
+    static typename delta_type::const_iterator find(const delta_type &delta, const key_type key) {
+        auto it = std::lower_bound(delta.begin(), delta.end(), key, [](const delta_entry &e, const key_type k) {
+            return e.key < k;
+        });
+        return it != delta.end() and it->key == key ? it : delta.end();
+    }
+
+    /**
+     * Adds @p entry to the delta of segment @p s and retrains the segment if the delta exceeds the threshold.
+     * @param s segment to update
+     * @param entry to add, its key must not be in the delta yet
+     */
+    void buffer(segment &s, const delta_entry entry) {
+        if (not s.delta) s.delta = std::make_unique<delta_type>();
+        auto it = std::lower_bound(s.delta->begin(), s.delta->end(), entry.key,
+                                   [](const delta_entry &e, const key_type k) { return e.key < k; });
+        s.delta->insert(it, entry);
+        if (s.delta->size() > delta_threshold_) {
+            merge(s);
+            train(s);
+        }
+    }
+
+    /**
+     * Merges the delta of segment @p s into its sorted keys and discards the delta.
+     * @param s segment to merge
+     */
+    static void merge(segment &s) {
+        std::vector<key_type> keys;
+        keys.reserve(s.keys.size() + s.delta->size());
+        auto it = s.keys.begin();
+        for (const delta_entry &e : *s.delta) {
+            auto pos = std::lower_bound(it, s.keys.end(), e.key);
+            keys.insert(keys.end(), it, pos);
+            it = pos;
+            if (e.tombstone) {
+                ++it; // skip deleted key
+            } else {
+                keys.push_back(e.key);
+            }
+        }
+        keys.insert(keys.end(), it, s.keys.end());
+        s.keys = std::move(keys);
+        s.delta.reset();
+    }
+
+    /**
+     * Trains the model of segment @p s on its sorted keys and computes its local absolute error bound.
+     * @param s segment to train
+     */
+    static void train(segment &s) {
+        std::size_t n = s.keys.size();
+        s.model = layer2_type(s.keys.begin(), s.keys.end(), 0);
+        s.error = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            std::size_t pred = clamp_prediction(s.model.predict(s.keys[i]), n - 1);
+            s.error = std::max(s.error, pred > i ? pred - i : i - pred);
+        }
+    }
+};
+
+} // namespace rmi
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+
+
+namespace rmi {
+
+constexpr std::size_t huge_page_2m = std::size_t(1) << 21; ///< Size of a 2 MiB huge page in bytes.
+constexpr std::size_t huge_page_1g = std::size_t(1) << 30; ///< Size of a 1 GiB huge page in bytes.
+
+/**
+ * Allocator that backs arrays of at least half a huge page with huge pages, which reduces TLB misses when accessing
+ * large arrays at random, e.g., the layer2 models of an index.
+ *
+ * Memory is mapped anonymously and aligned to @p PageSize. For 1 GiB pages, explicit huge pages are requested from
+ * the pool reserved via `hugetlbfs`. For 2 MiB pages, or if no 1 GiB pages are available, the kernel is advised to
+ * back the mapping with transparent huge pages. Smaller arrays are allocated by `operator new` since rounding them up
+ * to a huge page would waste memory.
+ *
+ * @tparam T the type of the values to allocate
+ * @tparam PageSize the size of a huge page in bytes, either #huge_page_2m or #huge_page_1g
+ */
+template<typename T, std::size_t PageSize = huge_page_2m>
+class HugePageAllocator
+{
+    static_assert(PageSize == huge_page_2m or PageSize == huge_page_1g, "page size must be 2 MiB or 1 GiB");
+
+    public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = HugePageAllocator<U, PageSize>; };
+
+    /**
+     * Default constructor.
+     */
+    HugePageAllocator() = default;
+
+    /**
+     * Converting constructor from an allocator for a different type.
+     */
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U, PageSize>&) noexcept { }
+
+    /**
+     * Allocates uninitialized memory for @p n values.
+     * @param n number of values
+     * @return pointer to the allocated memory
+     */
+    T * allocate(const std::size_t n) {
+        const std::size_t bytes = n * sizeof(T);
+        if (not use_huge_pages(bytes))
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+
+        const std::size_t size = round_up(bytes);
+        void *addr = MAP_FAILED;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+        if constexpr (PageSize == huge_page_1g) // explicit huge pages, fails if none are reserved
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+#endif
+        if (addr == MAP_FAILED) addr = map_aligned(size);
+        if (addr == MAP_FAILED) throw std::bad_alloc();
+        return static_cast<T*>(addr);
+    }
+
+    /**
+     * Releases the memory of @p n values at @p p allocated by #allocate().
+     * @param p pointer to the allocated memory
+     * @param n number of values
+     */
+    void deallocate(T *p, const std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (not use_huge_pages(bytes)) {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+            return;
+        }
+        munmap(p, round_up(bytes));
+    }
+
+    private:
+    /**
+     * Returns whether an array of @p bytes bytes is backed by huge pages.
+     * @param bytes size of the array in bytes
+     * @return whether the array is backed by huge pages
+     */
+    static bool use_huge_pages(const std::size_t bytes) { return bytes >= PageSize / 2; }
+
+    /**
+     * Rounds @p bytes up to a multiple of the page size.
+     * @param bytes number of bytes
+     * @return @p bytes rounded up to a multiple of the page size
+     */
+    static std::size_t round_up(const std::size_t bytes) { return (bytes + PageSize - 1) / PageSize * PageSize; }
+
+    /**
+     * Maps @p size bytes aligned to the page size and advises the kernel to use transparent huge pages. The mapping is
+     * over-allocated by one page and trimmed since huge pages can only back aligned ranges.
+     * @param size number of bytes, a multiple of the page size
+     * @return address of the mapping or `MAP_FAILED`
+     */
+    static void * map_aligned(const std::size_t size) {
+        void *addr = mmap(nullptr, size + PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) return MAP_FAILED;
+        const auto begin = reinterpret_cast<std::uintptr_t>(addr);
+        const auto aligned = (begin + PageSize - 1) / PageSize * PageSize;
+        if (aligned != begin) munmap(addr, aligned - begin); // trim head
+        if (aligned + size != begin + size + PageSize) // trim tail
+            munmap(reinterpret_cast<void*>(aligned + size), begin + PageSize - aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void*>(aligned);
+    }
+};
+
+template<typename T, typename U, std::size_t PageSize>
+bool operator==(const HugePageAllocator<T, PageSize>&, const HugePageAllocator<U, PageSize>&) { return true; }
+
+template<typename T, typename U, std::size_t PageSize>
+bool operator!=(const HugePageAllocator<T, PageSize>&, const HugePageAllocator<U, PageSize>&) { return false; }
+
+} // namespace rmi
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "rmi/util/serialize.hpp"
+
+
+namespace rmi {
+
+/**
+ * Immutable vector of unsigned integers that stores all values with the narrowest width out of 8, 16, 32, and 64 bits
+ * that fits the largest value. The width is chosen once at construction, so element access only requires a single,
+ * well-predictable branch.
+ *
+ * A compact vector either owns its values or, when loaded from a file, refers to values inside a memory mapping.
+ */
+class CompactVector
+{
+    public:
+    using value_type = std::size_t;
+
+    private:
+    std::size_t size_;                   ///< The number of values.
+    std::size_t width_;                  ///< The number of bytes used per value.
+    std::vector<unsigned char> storage_; ///< The values stored with #width_ bytes each, unless loaded from a file.
+    const unsigned char *data_;          ///< Pointer to the values, either into #storage_ or into a mapped file.
+
+    /**
+     * Returns the number of bytes needed to represent @p max_value, which is either 1, 2, 4, or 8.
+     * @param max_value the value to represent
+     * @return number of bytes needed to represent the value
+     */
+    static std::size_t width_of(const value_type max_value) {
+        if (max_value <= std::numeric_limits<std::uint8_t>::max()) return sizeof(std::uint8_t);
+        if (max_value <= std::numeric_limits<std::uint16_t>::max()) return sizeof(std::uint16_t);
+        if (max_value <= std::numeric_limits<std::uint32_t>::max()) return sizeof(std::uint32_t);
+        return sizeof(std::uint64_t);
+    }
+
+    /**
+     * Returns the value stored at byte offset @p offset as unsigned integer of type @p T.
+     * @tparam T the type the value is stored as
+     * @param offset the byte offset of the value
+     * @return the value
+     */
+    template<typename T>
+    value_type load(const std::size_t offset) const {
+        T value;
+        std::memcpy(&value, &data_[offset], sizeof(T));
+        return value;
+    }
+
+    /**
+     * Stores @p value at byte offset @p offset as unsigned integer of type @p T.
+     * @tparam T the type the value is stored as
+     * @param offset the byte offset of the value
+     * @param value the value
+     */
+    template<typename T>
+    void store(const std::size_t offset, const value_type value) {
+        T v = static_cast<T>(value);
+        std::memcpy(&storage_[offset], &v, sizeof(T));
+    }
+
+    /**
+     * Returns whether the values are owned, i.e., not loaded from a file.
+     * @return whether the values are owned
+     */
+    bool owns_data() const { return data_ == storage_.data(); }
+
+    public:
+    /**
+     * Default constructor.
+     */
+    CompactVector() : size_(0), width_(sizeof(std::uint8_t)), data_(nullptr) { }
+
+    /**
+     * Builds a compact vector holding the same values as @p values.
+     * @param values to be stored
+     */
+    explicit CompactVector(const std::vector<value_type> &values)
+        : size_(values.size())
+        , width_(width_of(values.empty() ? 0 : *std::max_element(values.begin(), values.end())))
+        , storage_(size_ * width_)
+        , data_(storage_.data())
+    {
+        for (std::size_t i = 0; i != size_; ++i) {
+            switch (width_) {
+                case 1: store<std::uint8_t>(i, values[i]); break;
+                case 2: store<std::uint16_t>(2 * i, values[i]); break;
+                case 4: store<std::uint32_t>(4 * i, values[i]); break;
+                default: store<std::uint64_t>(8 * i, values[i]); break;
+            }
+        }
+    }
+
+    /**
+     * Copy constructor.
+     * @param other compact vector to be copied
+     */
+    CompactVector(const CompactVector &other)
+        : size_(other.size_)
+        , width_(other.width_)
+        , storage_(other.storage_)
+        , data_(other.owns_data() ? storage_.data() : other.data_) { }
+
+    /**
+     * Move constructor.
+     * @param other compact vector to be moved
+     */
+    CompactVector(CompactVector &&other) noexcept
+        : size_(std::exchange(other.size_, 0))
+        , width_(other.width_)
+        , storage_(std::move(other.storage_)) // moving a vector keeps its buffer
+        , data_(std::exchange(other.data_, nullptr)) { }
+
+    /**
+     * Copy and move assignment operator.
+     * @param other compact vector to be assigned
+     * @return this compact vector
+     */
+    CompactVector & operator=(CompactVector other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(width_, other.width_);
+        storage_.swap(other.storage_); // swapping vectors keeps their buffers
+        std::swap(data_, other.data_);
+        return *this;
+    }
+
+    /**
+     * Writes the compact vector to @p out.
+     * @param out writer to write to
+     */
+    void save(Writer &out) const {
+        out.write(size_);
+        out.write(width_);
+        out.align();
+        out.write(data_, size_ * width_);
+        out.align();
+    }
+
+    /**
+     * Reads a compact vector from @p in. The values are used in place and stay valid as long as the mapping of @p in.
+     * @param in reader to read from
+     * @return the compact vector
+     */
+    static CompactVector load(Reader &in) {
+        CompactVector v;
+        v.size_ = in.read<std::size_t>();
+        v.width_ = in.read<std::size_t>();
+        if (v.width_ != 1 and v.width_ != 2 and v.width_ != 4 and v.width_ != 8) in.fail();
+        in.align();
+        v.data_ = static_cast<const unsigned char*>(in.read(v.size_ * v.width_));
+        in.align();
+        return v;
+    }
+
+    /**
+     * Returns the value at position @p i.
+     * @param i the position of the value
+     * @return the value at position @p i
+     */
+    value_type operator[](const std::size_t i) const {
+        switch (width_) {
+            case 1: return load<std::uint8_t>(i);
+            case 2: return load<std::uint16_t>(2 * i);
+            case 4: return load<std::uint32_t>(4 * i);
+            default: return load<std::uint64_t>(8 * i);
+        }
+    }
+
+    /**
+     * Returns the address of the value at position @p i, e.g., for prefetching.
+     * @param i the position of the value
+     * @return the address of the value at position @p i
+     */
+    const void * address(const std::size_t i) const { return &data_[i * width_]; }
+
+    /**
+     * Returns the number of values.
+     * @return the number of values
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * Returns the number of bytes used per value.
+     * @return the number of bytes used per value
+     */
+    std::size_t width() const { return width_; }
+
+    /**
+     * Returns the size of the stored values in bytes.
+     * @return size of the stored values in bytes
+     */
+    std::size_t size_in_bytes() const { return size_ * width_ + sizeof(width_); }
+};
+
+} // namespace rmi
@@ -0,0 +1,547 @@
+#pragma once
+
+#if __cplusplus < 202002L
+#error "rmi/util/coro.hpp requires C++20"
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "rmi/util/search.hpp"
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Coroutine Infrastructure
+ *====================================================================================================================*/
+
+/**
+ * Thread-local free lists of coroutine frames. Interleaved lookups create one coroutine frame per lookup and per
+ * search, hence frames are recycled instead of being returned to the general purpose allocator. Frames are grouped
+ * into size classes of 64 bytes; larger frames are not recycled. The free frames of a thread are returned to the
+ * general purpose allocator when the thread exits.
+ */
+class FramePool
+{
+    /**
+     * Header of a free frame.
+     */
+    struct Node {
+        Node *next; ///< The next free frame of the same size class.
+    };
+
+    static constexpr std::size_t granularity = 64; ///< The size difference between two size classes.
+    static constexpr std::size_t n_classes = 32;   ///< The number of size classes.
+
+    static inline thread_local Node *free_[n_classes] = {}; ///< The lists of free frames per size class.
+
+    /**
+     * Returns the free frames of the current thread to the general purpose allocator when destroyed at thread exit.
+     */
+    struct Releaser {
+        ~Releaser() {
+            for (Node *&head : free_) {
+                while (Node *node = head) {
+                    head = node->next;
+                    ::operator delete(node);
+                }
+            }
+        }
+    };
+
+    /**
+     * Allocates a new frame of @p size bytes. Since frames only enter the free lists of a thread after it allocated
+     * one here, the releaser is constructed off the path that recycles frames.
+     * @param size of the frame in bytes
+     * @return pointer to the frame
+     */
+    static void * allocate_new(std::size_t size) {
+        static thread_local Releaser releaser;
+        (void) releaser;
+        return ::operator new(size);
+    }
+
+    public:
+    /**
+     * Returns a frame of at least @p size bytes.
+     * @param size of the frame in bytes
+     * @return pointer to the frame
+     */
+    static void * allocate(std::size_t size) {
+        std::size_t c = (size - 1) / granularity;
+        if (c >= n_classes) return ::operator new(size);
+        if (Node *node = free_[c]) {
+            free_[c] = node->next;
+            return node;
+        }
+        return allocate_new((c + 1) * granularity);
+    }
+
+    /**
+     * Returns the frame @p p of @p size bytes to the free list of its size class.
+     * @param p pointer to the frame
+     * @param size of the frame in bytes
+     */
+    static void deallocate(void *p, std::size_t size) {
+        std::size_t c = (size - 1) / granularity;
+        if (c >= n_classes) return ::operator delete(p);
+        Node *node = static_cast<Node*>(p);
+        node->next = free_[c];
+        free_[c] = node;
+    }
+};
+
+
+/**
+ * A lazily started coroutine producing a value of type @p T.
+ *
+ * Tasks can await other tasks. All tasks of one call chain share a resume point that always refers to the innermost
+ * suspended coroutine, so that the executor can resume a lookup without knowing in which search it was suspended.
+ *
+ * @tparam T the type of the produced value
+ */
+template<typename T>
+class Task
+{
+    public:
+    /**
+     * Promise type of the coroutine.
+     */
+    struct promise_type {
+        T value_;                                ///< The produced value.
+        std::coroutine_handle<> continuation_;   ///< The coroutine awaiting this task, if any.
+        std::coroutine_handle<> resume_;         ///< The resume point if this task is the outermost one.
+        std::coroutine_handle<> *resume_point_;  ///< The resume point of the call chain.
+
+        /**
+         * Default constructor.
+         */
+        promise_type() : resume_point_(&resume_) {
+            resume_ = std::coroutine_handle<promise_type>::from_promise(*this);
+        }
+
+        /**
+         * Awaiter that transfers control to the awaiting coroutine, if any, after the task has finished.
+         */
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                auto &p = h.promise();
+                if (not p.continuation_) return std::noop_coroutine();
+                *p.resume_point_ = p.continuation_;
+                return p.continuation_;
+            }
+            void await_resume() const noexcept { }
+        };
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_value(T value) { value_ = std::move(value); }
+        void unhandled_exception() const noexcept { std::terminate(); }
+
+        static void * operator new(std::size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void *p, std::size_t size) { FramePool::deallocate(p, size); }
+    };
+
+    private:
+    std::coroutine_handle<promise_type> h_; ///< The handle of the coroutine.
+
+    explicit Task(std::coroutine_handle<promise_type> h) : h_(h) { }
+
+    public:
+    /**
+     * Default constructor.
+     */
+    Task() : h_(nullptr) { }
+
+    Task(const Task&) = delete;
+    Task & operator=(const Task&) = delete;
+
+    /**
+     * Move constructor.
+     */
+    Task(Task &&other) noexcept : h_(std::exchange(other.h_, nullptr)) { }
+
+    /**
+     * Move assignment operator.
+     */
+    Task & operator=(Task &&other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * Destructor.
+     */
+    ~Task() { if (h_) h_.destroy(); }
+
+    /**
+     * Returns whether the task has finished.
+     * @return whether the task has finished
+     */
+    bool done() const { return h_.done(); }
+
+    /**
+     * Resumes the innermost suspended coroutine of the call chain.
+     */
+    void resume() { h_.promise().resume_point_->resume(); }
+
+    /**
+     * Returns the produced value of a finished task.
+     * @return the produced value
+     */
+    T & result() { return h_.promise().value_; }
+
+    /**
+     * Awaiter that starts the task and resumes the awaiting coroutine once the task has finished.
+     */
+    struct Awaiter {
+        std::coroutine_handle<promise_type> h_; ///< The handle of the awaited coroutine.
+
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+            auto &p = h_.promise();
+            p.continuation_ = awaiting;
+            p.resume_point_ = awaiting.promise().resume_point_;
+            *p.resume_point_ = h_;
+            return h_;
+        }
+
+        T await_resume() { return std::move(h_.promise().value_); }
+    };
+
+    /**
+     * Awaits the task.
+     * @return awaiter of the task
+     */
+    Awaiter operator co_await() && { return Awaiter{h_}; }
+};
+
+
+/**
+ * Awaitable that prefetches an address and suspends the coroutine so that other lookups can proceed while the cache
+ * line is loaded. If @p addr is a null pointer, the coroutine is suspended without prefetching, e.g., after a caller
+ * issued prefetches itself.
+ */
+struct Prefetch {
+    const void *addr; ///< The address to prefetch.
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) const noexcept {
+        if (addr) __builtin_prefetch(addr);
+        *h.promise().resume_point_ = h;
+    }
+
+    void await_resume() const noexcept { }
+};
+
+
+/**
+ * Returns whether @p a and @p b lie in the same cache line.
+ * @param a, b the addresses to compare
+ * @return whether both addresses lie in the same cache line
+ */
+inline bool same_cache_line(const void *a, const void *b) {
+    constexpr std::uintptr_t line_size = 64;
+    return reinterpret_cast<std::uintptr_t>(a) / line_size == reinterpret_cast<std::uintptr_t>(b) / line_size;
+}
+
+
+/*======================================================================================================================
+ * Suspendable Search Algorithms
+ *====================================================================================================================*/
+
+/**
+ * Suspendable counterpart of LinearSearch. Suspends whenever the scan enters a new cache line.
+ */
+struct CoroLinearSearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+        const void *line = nullptr;
+        for (InputIt runner = first; runner != last; ++runner) {
+            if (not same_cache_line(line, &*runner)) { line = &*runner; co_await Prefetch{line}; }
+            if (*runner >= value) co_return runner;
+        }
+        co_return last;
+    }
+};
+
+
+/**
+ * Suspendable counterpart of ModelBiasedLinearSearch. Suspends whenever the scan enters a new cache line.
+ */
+struct CoroModelBiasedLinearSearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+        InputIt runner = pred;
+        const void *line = &*runner;
+        co_await Prefetch{line};
+        if (*runner < value) {
+            for (; runner < last; ++runner) { // search right side
+                if (not same_cache_line(line, &*runner)) { line = &*runner; co_await Prefetch{line}; }
+                if (*runner >= value) co_return runner;
+            }
+            co_return last;
+        } else {
+            for (; runner >= first; --runner) { // search left side
+                if (not same_cache_line(line, &*runner)) { line = &*runner; co_await Prefetch{line}; }
+                if (*runner < value) co_return ++runner;
+            }
+            co_return first;
+        }
+    }
+};
+
+
+/**
+ * Suspendable counterpart of std::lower_bound. Suspends before each probe that touches a new cache line.
+ * @param first, last iterators defining the partially-ordered range to examine
+ * @param value value to compare the elements to
+ * @return iterator to the first element that is not less than @p value
+ */
+template<typename InputIt, typename T>
+Task<InputIt> coro_lower_bound(InputIt first, InputIt last, const T &value) {
+    const void *line = nullptr;
+    auto count = std::distance(first, last);
+    while (count > 0) {
+        auto step = count / 2;
+        InputIt it = first + step;
+        if (not same_cache_line(line, &*it)) { line = &*it; co_await Prefetch{line}; }
+        if (*it < value) {
+            first = ++it;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    co_return first;
+}
+
+
+/**
+ * Suspendable counterpart of BinarySearch.
+ */
+struct CoroBinarySearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+        co_return co_await coro_lower_bound(first, last, value);
+    }
+};
+
+
+/**
+ * Suspendable counterpart of ModelBiasedBinarySearch.
+ */
+struct CoroModelBiasedBinarySearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+        co_await Prefetch{&*pred};
+        if (*pred < value) co_return co_await coro_lower_bound(pred, last, value); // search right side
+        else co_return co_await coro_lower_bound(first, pred, value); // search left side
+    }
+};
+
+
+/**
+ * Suspendable counterpart of ExponentialSearch.
+ */
+struct CoroExponentialSearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+        co_await Prefetch{&*first};
+        if (*first >= value) co_return first;
+        std::size_t bound = 1;
+        InputIt prev = first;
+        InputIt curr = prev + bound;
+        while (curr < last) {
+            if (not same_cache_line(&*prev, &*curr)) co_await Prefetch{&*curr};
+            if (not (*curr < value)) break;
+            bound *= 2;
+            prev = curr;
+            curr += bound;
+        }
+        co_return co_await coro_lower_bound(prev, std::min(curr + 1, last), value);
+    }
+};
+
+
+/**
+ * Suspendable counterpart of ModelBiasedExponentialSearch.
+ */
+struct CoroModelBiasedExponentialSearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+        co_await Prefetch{&*pred};
+        if (*pred < value) { // search right side
+            std::size_t bound = 1;
+            InputIt prev = pred;
+            InputIt curr = prev + bound;
+            while (curr < last) {
+                if (not same_cache_line(&*prev, &*curr)) co_await Prefetch{&*curr};
+                if (not (*curr < value)) break;
+                bound *= 2;
+                prev = curr;
+                curr += bound;
+            }
+            co_return co_await coro_lower_bound(prev, std::min(curr + 1, last), value);
+        } else { // search left side
+            std::size_t bound = 1;
+            InputIt prev = pred;
+            InputIt curr = prev - bound;
+            while (curr > first) {
+                if (not same_cache_line(&*prev, &*curr)) co_await Prefetch{&*curr};
+                if (not (*curr >= value)) break;
+                bound *= 2;
+                prev = curr;
+                curr -= bound;
+            }
+            co_return co_await coro_lower_bound(std::max(first, curr), prev, value);
+        }
+    }
+};
+
+
+/**
+ * Fallback for search algorithms without a suspendable counterpart: prefetches the estimated position, suspends once,
+ * and then runs @p Search to completion.
+ * @tparam Search the type of the search algorithm
+ */
+template<typename Search>
+struct CoroPrefetchedSearch {
+    template<typename InputIt, typename T>
+    Task<InputIt> operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+        co_await Prefetch{&*pred};
+        co_return Search()(first, last, pred, value);
+    }
+};
+
+
+/**
+ * Maps a search algorithm to its suspendable counterpart.
+ * @tparam Search the type of the search algorithm
+ */
+template<typename Search> struct suspendable { using type = CoroPrefetchedSearch<Search>; };
+template<> struct suspendable<LinearSearch> { using type = CoroLinearSearch; };
+template<> struct suspendable<ModelBiasedLinearSearch> { using type = CoroModelBiasedLinearSearch; };
+template<> struct suspendable<BinarySearch> { using type = CoroBinarySearch; };
+template<> struct suspendable<ModelBiasedBinarySearch> { using type = CoroModelBiasedBinarySearch; };
+template<> struct suspendable<ExponentialSearch> { using type = CoroExponentialSearch; };
+template<> struct suspendable<ModelBiasedExponentialSearch> { using type = CoroModelBiasedExponentialSearch; };
+
+template<typename Search>
+using suspendable_t = typename suspendable<Search>::type;
+
+
+/*======================================================================================================================
+ * Interleaved Lookups
+ *====================================================================================================================*/
+
+/**
+ * Performs a lookup on @p rmi as a coroutine that suspends before accessing the layer2 model and the error bounds and
+ * before each probe of the search algorithm that is likely to miss the cache. The layer1 model is assumed to be cache
+ * resident.
+ * @tparam Rmi the type of the index
+ * @tparam RandomIt the type of the iterator to the sorted keys
+ * @tparam Search the type of the suspendable search algorithm
+ * @tparam Key the type of the key
+ * @param rmi the index to perform the lookup on
+ * @param data iterator to the first of the keys the index was built on
+ * @param key to search for
+ * @return position of the first key that is not less than @p key
+ */
+template<typename Search, typename Rmi, typename RandomIt, typename Key>
+Task<std::size_t> coro_lookup(const Rmi &rmi, RandomIt data, const Key key) {
+    auto segment_id = rmi.get_segment_id(key);
+    rmi.prefetch_segment(segment_id);
+    co_await Prefetch{nullptr};
+    auto range = rmi.search(key, segment_id);
+    auto pos = co_await Search()(data + range.lo, data + range.hi, data + range.pos, key);
+    co_return std::distance(data, pos);
+}
+
+
+/**
+ * Runs @p n tasks created by @p make_task, keeping up to @p n_inflight of them in flight and resuming them round-robin
+ * whenever one suspends. The result of each task is passed to @p sink together with the task's index. At least one task
+ * is kept in flight, even if @p n_inflight is 0.
+ * @tparam MakeTask the type of the task factory
+ * @tparam Sink the type of the result consumer
+ * @param n number of tasks
+ * @param n_inflight maximum number of tasks in flight
+ * @param make_task callable that creates the task for a given index
+ * @param sink callable that consumes the index and result of a finished task
+ */
+template<typename MakeTask, typename Sink>
+void interleave(const std::size_t n, const std::size_t n_inflight, MakeTask make_task, Sink sink) {
+    using task_type = decltype(make_task(std::size_t(0)));
+
+    struct Slot {
+        task_type task;
+        std::size_t id;
+    };
+
+    const std::size_t n_slots = std::max<std::size_t>(n_inflight, 1);
+    std::vector<Slot> slots;
+    slots.reserve(n_slots);
+    std::size_t next = 0;
+    for (; next != std::min(n, n_slots); ++next)
+        slots.push_back({make_task(next), next});
+
+    std::size_t active = slots.size();
+    while (active) {
+        for (std::size_t s = 0; s < active; ) {
+            Slot &slot = slots[s];
+            slot.task.resume();
+            if (not slot.task.done()) {
+                ++s;
+                continue;
+            }
+            sink(slot.id, slot.task.result());
+            if (next < n) {
+                slot.task = make_task(next);
+                slot.id = next++;
+                ++s;
+            } else {
+                slot = std::move(slots[--active]);
+            }
+        }
+    }
+}
+
+
+/**
+ * Writes the positions of the first elements in the sorted range starting at @p data that are not less than each of
+ * the @p n keys to @p out. Up to @p n_inflight lookups are interleaved using coroutines.
+ * @tparam Search the type of the search algorithm, mapped to its suspendable counterpart
+ * @tparam Rmi the type of the index
+ * @tparam RandomIt the type of the iterator to the sorted keys
+ * @tparam Key the type of the keys
+ * @param rmi the index to perform the lookups on
+ * @param keys array of keys to search for
+ * @param n number of keys
+ * @param data iterator to the first of the keys the index was built on
+ * @param n_inflight maximum number of lookups in flight
+ * @param out array to write the positions to
+ */
+template<typename Search, typename Rmi, typename RandomIt, typename Key>
+void lower_bound_interleaved(const Rmi &rmi, const Key *keys, const std::size_t n, RandomIt data,
+                             const std::size_t n_inflight, std::size_t *out) {
+    interleave(n, n_inflight,
+               [&](std::size_t i) { return coro_lookup<suspendable_t<Search>>(rmi, data, keys[i]); },
+               [&](std::size_t i, std::size_t pos) { out[i] = pos; });
+}
+
+} // namespace rmi
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rmi/util/allocator.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/**
+ * Non-owning view of a contiguous array of sorted keys. It provides the subset of the interface of `std::vector` used
+ * by indexes and search functors, whose iterators are plain pointers.
+ * @tparam Key the type of the keys
+ */
+template<typename Key>
+class KeySpan
+{
+    public:
+    using value_type = Key;
+    using const_iterator = const Key *;
+
+    private:
+    const Key *data_ = nullptr; ///< The first key.
+    std::size_t size_ = 0;      ///< The number of keys.
+
+    public:
+    /**
+     * Default constructor, creates an empty span.
+     */
+    KeySpan() = default;
+
+    /**
+     * Creates a span of the @p size keys starting at @p data.
+     * @param data pointer to the first key
+     * @param size number of keys
+     */
+    KeySpan(const Key *data, const std::size_t size) : data_(data), size_(size) { }
+
+    /**
+     * Creates a span of the keys of @p keys, which must outlive the span.
+     * @param keys vector of keys
+     */
+    KeySpan(const std::vector<Key> &keys) : data_(keys.data()), size_(keys.size()) { }
+
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    const Key * data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Key & operator[](const std::size_t i) const { return data_[i]; }
+    const Key & front() const { return data_[0]; }
+    const Key & back() const { return data_[size_ - 1]; }
+};
+
+/**
+ * Keys of a dataset file in binary format, i.e., the number of keys as `uint64_t` followed by the keys, as written by
+ * SOSD. The dataset owns the memory holding the keys and hands out non-owning views via #keys(). Besides reading the
+ * file like load_data(), keys can be loaded in two ways that avoid zero-filling and copying through a stream buffer:
+ *
+ * - #map() maps the file read-only and prefaults all pages, so no copy is made at all if the file is in the page cache.
+ *   The kernel is advised to back the mapping with huge pages, which only takes effect on file systems supporting
+ *   transparent huge pages for the page cache.
+ * - #read_parallel() reads disjoint chunks of the file with `pread` on several threads into memory backed by
+ *   transparent huge pages, which reduces TLB misses of lookups at the cost of one copy.
+ * - #read_zstd() decompresses a file compressed with zstd straight into memory backed by huge pages, see ZstdFile.
+ *
+ * @tparam Key the type of the keys
+ */
+template<typename Key>
+class Dataset
+{
+    using key_type = Key;
+    using allocator_type = HugePageAllocator<key_type>;
+
+    std::vector<key_type> vector_; ///< The keys if read into a vector.
+    key_type *buffer_ = nullptr;   ///< The keys if read into huge-page memory.
+    void *map_ = nullptr;          ///< The mapping of the file if mapped.
+    std::size_t map_bytes_ = 0;    ///< The size of the mapping in bytes.
+    KeySpan<key_type> keys_;       ///< View of the keys.
+
+    Dataset() = default;
+
+    public:
+    Dataset(const Dataset&) = delete;
+    Dataset & operator=(const Dataset&) = delete;
+
+    Dataset(Dataset &&other) noexcept
+        : vector_(std::move(other.vector_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+        , map_(std::exchange(other.map_, nullptr))
+        , map_bytes_(std::exchange(other.map_bytes_, 0))
+        , keys_(std::exchange(other.keys_, KeySpan<key_type>())) { }
+
+    Dataset & operator=(Dataset &&other) noexcept {
+        if (this != &other) {
+            release();
+            vector_ = std::move(other.vector_);
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            map_ = std::exchange(other.map_, nullptr);
+            map_bytes_ = std::exchange(other.map_bytes_, 0);
+            keys_ = std::exchange(other.keys_, KeySpan<key_type>());
+        }
+        return *this;
+    }
+
+    ~Dataset() { release(); }
+
+    /**
+     * Returns a view of the keys, which is valid as long as the dataset lives.
+     * @return view of the keys
+     */
+    KeySpan<key_type> keys() const { return keys_; }
+
+    /**
+     * Reads the dataset file @p filename into a vector using load_data().
+     * @param filename name of the dataset file
+     * @return the dataset
+     */
+    static Dataset read(const std::string &filename) {
+        Dataset dataset;
+        dataset.vector_ = load_data<key_type>(filename);
+        dataset.keys_ = KeySpan<key_type>(dataset.vector_);
+        return dataset;
+    }
+
+    /**
+     * Maps the dataset file @p filename into memory and prefaults all its pages. The keys start at offset 8 of the
+     * mapping, right after the number of keys.
+     * @param filename name of the dataset file
+     * @return the dataset
+     */
+    static Dataset map(const std::string &filename) {
+        static_assert(alignof(key_type) <= sizeof(std::uint64_t), "keys of mapped files are aligned to 8 bytes");
+        int fd = open_file(filename);
+        const std::size_t n_keys = read_n_keys(fd, filename);
+
+        Dataset dataset;
+        dataset.map_bytes_ = sizeof(std::uint64_t) + n_keys * sizeof(key_type);
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void *addr = mmap(nullptr, dataset.map_bytes_, PROT_READ, flags, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            std::cerr << "Could not map " << filename << ": " << std::strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(addr, dataset.map_bytes_, MADV_HUGEPAGE);
+#endif
+        dataset.map_ = addr;
+        auto keys = reinterpret_cast<const key_type*>(static_cast<const char*>(addr) + sizeof(std::uint64_t));
+        dataset.keys_ = KeySpan<key_type>(keys, n_keys);
+        return dataset;
+    }
+
+    /**
+     * Reads the dataset file @p filename into memory backed by huge pages using @p n_threads threads, each of which
+     * reads a contiguous chunk of the keys with `pread`.
+     * @param filename name of the dataset file
+     * @param n_threads number of threads
+     * @return the dataset
+     */
+    static Dataset read_parallel(const std::string &filename,
+                                 const std::size_t n_threads = std::thread::hardware_concurrency()) {
+        int fd = open_file(filename);
+        const std::size_t n_keys = read_n_keys(fd, filename);
+
+        Dataset dataset;
+        if (n_keys != 0) dataset.buffer_ = allocator_type().allocate(n_keys);
+        dataset.keys_ = KeySpan<key_type>(dataset.buffer_, n_keys);
+
+        // Split keys into chunks of whole huge pages so that each page is faulted in by a single thread.
+        const std::size_t page_keys = huge_page_2m / sizeof(key_type);
+        const std::size_t n_pages = (n_keys + page_keys - 1) / page_keys;
+        const std::size_t n_chunks = std::max<std::size_t>(std::min(n_threads, n_pages), 1);
+        const std::size_t chunk_keys = (n_pages + n_chunks - 1) / n_chunks * page_keys;
+        std::vector<int> errors(n_chunks, 0);
+        parallel_for(n_chunks, [&](const std::size_t i) {
+            const std::size_t begin = std::min(i * chunk_keys, n_keys);
+            const std::size_t end = std::min(begin + chunk_keys, n_keys);
+            auto buf = reinterpret_cast<char*>(dataset.buffer_ + begin);
+            std::size_t bytes = (end - begin) * sizeof(key_type);
+            off_t offset = sizeof(std::uint64_t) + begin * sizeof(key_type);
+            while (bytes != 0) {
+                ssize_t n = pread(fd, buf, bytes, offset);
+                if (n < 0 and errno == EINTR) continue;
+                if (n <= 0) { // error or unexpected end of file
+                    errors[i] = n < 0 ? errno : EIO;
+                    return;
+                }
+                buf += n;
+                bytes -= n;
+                offset += n;
+            }
+        });
+        close(fd);
+        for (int error : errors) {
+            if (error != 0) {
+                std::cerr << "Could not read " << filename << ": " << std::strerror(error) << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        return dataset;
+    }
+
+#if RMI_ZSTD
+    /**
+     * Decompresses the dataset file @p filename compressed with zstd into memory backed by huge pages using up to
+     * @p n_threads threads.
+     * @param filename name of the compressed dataset file
+     * @param n_threads maximum number of threads
+     * @return the dataset
+     */
+    static Dataset read_zstd(const std::string &filename,
+                             const std::size_t n_threads = std::thread::hardware_concurrency()) {
+        ZstdFile file(filename);
+        const std::size_t n_keys = file.n_keys();
+
+        Dataset dataset;
+        if (n_keys != 0) dataset.buffer_ = allocator_type().allocate(n_keys);
+        dataset.keys_ = KeySpan<key_type>(dataset.buffer_, n_keys);
+        file.decompress(dataset.buffer_, n_keys, n_threads);
+        return dataset;
+    }
+#endif
+
+    /**
+     * Loads the dataset file @p filename using @p loader, either `read`, `mmap`, or `pread`. Files ending with `.zst`
+     * are decompressed by #read_zstd() unless @p loader is `read`, which decompresses them into a vector.
+     * @param filename name of the dataset file
+     * @param loader name of the loader
+     * @return the dataset
+     */
+    static Dataset load(const std::string &filename, const std::string &loader) {
+        if (loader == "read") return read(filename);
+        if (is_zstd_file(filename) and (loader == "mmap" or loader == "pread")) {
+#if RMI_ZSTD
+            return read_zstd(filename);
+#else
+            return read(filename); // reports missing zstd support
+#endif
+        }
+        if (loader == "mmap") return map(filename);
+        if (loader == "pread") return read_parallel(filename);
+        std::cerr << "Error: " << loader << " is not a valid loader." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    private:
+    /**
+     * Releases the memory holding the keys.
+     */
+    void release() {
+        if (buffer_) allocator_type().deallocate(buffer_, keys_.size());
+        if (map_) munmap(map_, map_bytes_);
+        buffer_ = nullptr;
+        map_ = nullptr;
+        vector_ = std::vector<key_type>();
+        keys_ = KeySpan<key_type>();
+    }
+
+    /**
+     * Opens @p filename for reading.
+     * @param filename name of the file
+     * @return file descriptor
+     */
+    static int open_file(const std::string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Could not load " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        return fd;
+    }
+
+    /**
+     * Reads the number of keys from the header of the dataset file @p filename opened as @p fd and checks that the
+     * file holds that many keys.
+     * @param fd file descriptor of the dataset file
+     * @param filename name of the dataset file
+     * @return the number of keys
+     */
+    static std::size_t read_n_keys(const int fd, const std::string &filename) {
+        std::uint64_t n_keys;
+        struct stat st;
+        if (pread(fd, &n_keys, sizeof(n_keys), 0) != sizeof(n_keys) or fstat(fd, &st) != 0 or
+            static_cast<std::uint64_t>(st.st_size) < sizeof(n_keys) + n_keys * sizeof(key_type)) {
+            std::cerr << "Could not load " << filename << ": file is truncated." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        return n_keys;
+    }
+};
+
+} // namespace rmi
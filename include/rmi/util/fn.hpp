@@ -1,14 +1,38 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Whether datasets compressed with zstd can be loaded, which requires linking `libzstd`. Detected from the presence of
+ * `zstd.h` unless defined, e.g., as 0 by the build if the header is present but the library is not.
+ */
+#ifndef RMI_ZSTD
+#if __has_include(<zstd.h>)
+#define RMI_ZSTD 1
+#else
+#define RMI_ZSTD 0
+#endif
+#endif
+
+#if RMI_ZSTD
+#include <zstd.h>
+#endif
+
 
 /*======================================================================================================================
  * Bit Functions
@@ -51,18 +75,51 @@ template<typename Numeric>
 uint8_t common_prefix_width(Numeric v1, Numeric v2)
 {
     Numeric Xor = v1 ^ v2; // bit-wise xor
+    if (Xor == 0) return sizeof(Numeric) * 8; // equal values, leading zeros of zero are undefined
 
     if constexpr (sizeof(Numeric) <= sizeof(unsigned)) {
-        return __builtin_clz(Xor);
+        return __builtin_clz(Xor) - (sizeof(unsigned) - sizeof(Numeric)) * 8;
     } else if constexpr (sizeof(Numeric) <= sizeof(unsigned long)) {
         return __builtin_clzl(Xor);
     } else if constexpr (sizeof(Numeric) <= sizeof(unsigned long long)) {
         return __builtin_clzll(Xor);
+    } else if constexpr (sizeof(Numeric) == 2 * sizeof(unsigned long long)) {
+        auto hi = static_cast<unsigned long long>(Xor >> 64);
+        auto lo = static_cast<unsigned long long>(Xor);
+        return hi != 0 ? __builtin_clzll(hi) : 64 + __builtin_clzll(lo);
     } else {
-        static_assert(sizeof(Numeric) > sizeof(unsigned long long), "unsupported width of integral type");
+        static_assert(sizeof(Numeric) > 2 * sizeof(unsigned long long), "unsupported width of integral type");
     }
 }
 
+/**
+ * Computes the smallest power of two that is not less than @p n.
+ * @param n the value
+ * @return the smallest power of two not less than @p n
+ */
+constexpr std::size_t next_power_of_two(std::size_t n)
+{
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/**
+ * Clamps the prediction @p pred of a model to the range [0, @p max]. Floating-point predictions are clamped as
+ * `double`, integer predictions, e.g., of fixed-point models, are clamped without conversion to floating point.
+ * @param pred the prediction
+ * @param max the largest valid value
+ * @return the clamped prediction
+ */
+template<typename Numeric>
+std::size_t clamp_prediction(const Numeric pred, const std::size_t max)
+{
+    if constexpr (std::is_integral<Numeric>::value)
+        return std::clamp<std::int64_t>(pred, 0, max);
+    else
+        return std::clamp<double>(pred, 0, max);
+}
+
 
 /*======================================================================================================================
  * String Functions
@@ -150,12 +207,258 @@ Numeric max(std::vector<Numeric> &v)
 }
 
 
+/*======================================================================================================================
+ * Parallel Functions
+ *====================================================================================================================*/
+
+/**
+ * Invokes @p fn for each index in [0, n), each on its own thread. Index 0 is processed by the calling thread.
+ * @tparam Fn the type of the function
+ * @param n number of indexes
+ * @param fn function to invoke with each index
+ */
+template<typename Fn>
+void parallel_for(const std::size_t n, Fn fn)
+{
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < n; ++i)
+        threads.emplace_back(fn, i);
+    if (n > 0) fn(0);
+    for (auto &t : threads)
+        t.join();
+}
+
+
 /*======================================================================================================================
  * Dataset Functions
  *====================================================================================================================*/
 
 /**
- * Reads a dataset file @p filename in binary format and writes keys to vector.
+ * Returns whether @p filename names a dataset file compressed with zstd, i.e., ends with `.zst`.
+ * @param filename name of the dataset file
+ * @return whether the file is compressed
+ */
+inline bool is_zstd_file(const std::string &filename)
+{
+    const std::string suffix = ".zst";
+    return filename.size() > suffix.size() and
+           filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+#if RMI_ZSTD
+/**
+ * Dataset file in binary format compressed with zstd, e.g., as downloaded from SOSD. The compressed file is mapped into
+ * memory and decompressed straight into the memory of the keys without writing the decompressed file to disk.
+ *
+ * A file consisting of several frames whose decompressed sizes are stored in their headers, e.g., as written by
+ * `pzstd`, is decompressed in parallel, each thread decompressing a contiguous group of frames to its offset in the
+ * keys. Other files are decompressed sequentially. Alternatively, keys can be streamed in chunks via #for_each_chunk(),
+ * e.g., into an rmi::RmiBuilder, without holding all keys in memory.
+ */
+class ZstdFile
+{
+    static constexpr std::size_t header_size = sizeof(std::uint64_t); ///< The size of the number of keys in bytes.
+
+    std::string filename_; ///< The name of the compressed file.
+    char *data_ = nullptr; ///< The mapping of the compressed file.
+    std::size_t size_ = 0; ///< The size of the compressed file in bytes.
+
+    public:
+    /**
+     * Opens and maps the compressed dataset file @p filename.
+     * @param filename name of the compressed dataset file
+     */
+    explicit ZstdFile(const std::string &filename) : filename_(filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 or fstat(fd, &st) != 0) {
+            std::cerr << "Could not load " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        size_ = st.st_size;
+        void *addr = size_ == 0 ? MAP_FAILED : mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) fail("file is empty or cannot be mapped");
+        madvise(addr, size_, MADV_WILLNEED);
+        data_ = static_cast<char*>(addr);
+    }
+
+    ZstdFile(const ZstdFile&) = delete;
+    ZstdFile & operator=(const ZstdFile&) = delete;
+
+    ~ZstdFile() { munmap(data_, size_); }
+
+    /**
+     * Reads the number of keys from the header of the decompressed file.
+     * @return the number of keys
+     */
+    std::uint64_t n_keys() const {
+        ZSTD_DCtx *dctx = create_context();
+        ZSTD_inBuffer in{data_, size_, 0};
+        std::uint64_t n_keys = read_header(dctx, in);
+        ZSTD_freeDCtx(dctx);
+        return n_keys;
+    }
+
+    /**
+     * Decompresses the @p n_keys keys of the file into @p keys using up to @p n_threads threads.
+     * @tparam Key the type of the keys
+     * @param keys array of @p n_keys keys to write to
+     * @param n_keys the number of keys as returned by #n_keys()
+     * @param n_threads maximum number of threads
+     */
+    template<typename Key>
+    void decompress(Key *keys, const std::size_t n_keys,
+                    const std::size_t n_threads = std::thread::hardware_concurrency()) const {
+        const std::size_t keys_bytes = n_keys * sizeof(Key);
+        auto dst = reinterpret_cast<char*>(keys);
+
+        // Locate frames and the offsets of their decompressed bytes.
+        std::vector<std::size_t> begins; // compressed offsets of the frames, followed by the size of the file
+        std::vector<std::size_t> offsets; // decompressed offsets of the frames
+        bool sizes_known = true;
+        std::size_t offset = 0;
+        for (std::size_t pos = 0; pos != size_; ) {
+            std::size_t frame_size = ZSTD_findFrameCompressedSize(data_ + pos, size_ - pos);
+            if (ZSTD_isError(frame_size)) fail(ZSTD_getErrorName(frame_size));
+            unsigned long long content_size = ZSTD_getFrameContentSize(data_ + pos, size_ - pos);
+            if (content_size == ZSTD_CONTENTSIZE_UNKNOWN or content_size == ZSTD_CONTENTSIZE_ERROR)
+                sizes_known = false;
+            begins.push_back(pos);
+            offsets.push_back(offset);
+            offset += content_size;
+            pos += frame_size;
+        }
+        begins.push_back(size_);
+
+        const std::size_t n_frames = offsets.size();
+        if (not sizes_known or n_frames == 1 or n_threads <= 1) {
+            if (decompress_frames(data_, size_, 0, dst, keys_bytes) != header_size + keys_bytes)
+                fail("size does not match the number of keys");
+            return;
+        }
+        if (offset != header_size + keys_bytes) fail("size does not match the number of keys");
+
+        // Decompress contiguous groups of frames in parallel.
+        const std::size_t n_groups = std::min(n_threads, n_frames);
+        parallel_for(n_groups, [&](const std::size_t i) {
+            const std::size_t first = i * n_frames / n_groups;
+            const std::size_t last = (i + 1) * n_frames / n_groups;
+            decompress_frames(data_ + begins[first], begins[last] - begins[first], offsets[first], dst, keys_bytes);
+        });
+    }
+
+    /**
+     * Decompresses the keys of the file sequentially in chunks of @p chunk_size keys and invokes @p fn with a pointer
+     * to each chunk and its number of keys. Only one chunk is held in memory.
+     * @tparam Key the type of the keys
+     * @tparam Fn the type of the function
+     * @param fn function to invoke with each chunk
+     * @param chunk_size number of keys per chunk
+     */
+    template<typename Key, typename Fn>
+    void for_each_chunk(Fn fn, const std::size_t chunk_size = 1UL << 16) const {
+        std::vector<Key> chunk(chunk_size);
+        ZSTD_DCtx *dctx = create_context();
+        ZSTD_inBuffer in{data_, size_, 0};
+        const std::uint64_t n_keys = read_header(dctx, in);
+        ZSTD_outBuffer out{chunk.data(), chunk_size * sizeof(Key), 0};
+        std::size_t n_read = 0;
+        while (true) {
+            const std::size_t in_pos = in.pos, out_pos = out.pos;
+            std::size_t ret = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(ret)) fail(ZSTD_getErrorName(ret));
+            if (out.pos == out.size) { // chunk is full
+                fn(static_cast<const Key*>(chunk.data()), chunk_size);
+                n_read += chunk_size;
+                out.pos = 0;
+            } else if (in.pos == in.size and ret == 0) { // all frames are complete
+                break;
+            } else if (in.pos == in_pos and out.pos == out_pos) { // no progress, last frame is incomplete
+                fail("file is truncated");
+            }
+        }
+        ZSTD_freeDCtx(dctx);
+        if (out.pos % sizeof(Key) != 0) fail("file is truncated");
+        if (out.pos != 0) fn(static_cast<const Key*>(chunk.data()), out.pos / sizeof(Key));
+        n_read += out.pos / sizeof(Key);
+        if (n_read != n_keys) fail("size does not match the number of keys");
+    }
+
+    private:
+    /**
+     * Reports an error about the file and exits.
+     * @param what description of the error
+     */
+    [[noreturn]] void fail(const std::string &what) const {
+        std::cerr << "Could not load " << filename_ << ": " << what << '.' << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /**
+     * Creates a decompression context.
+     * @return the decompression context
+     */
+    ZSTD_DCtx * create_context() const {
+        ZSTD_DCtx *dctx = ZSTD_createDCtx();
+        if (dctx == nullptr) fail("cannot create decompression context");
+        return dctx;
+    }
+
+    /**
+     * Decompresses the number of keys at the beginning of the decompressed file from @p in using @p dctx.
+     * @param dctx the decompression context
+     * @param in the compressed file, positioned at its beginning
+     * @return the number of keys
+     */
+    std::uint64_t read_header(ZSTD_DCtx *dctx, ZSTD_inBuffer &in) const {
+        std::uint64_t n_keys;
+        ZSTD_outBuffer out{&n_keys, header_size, 0};
+        while (out.pos != out.size and in.pos != in.size) {
+            std::size_t ret = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(ret)) fail(ZSTD_getErrorName(ret));
+        }
+        if (out.pos != out.size) fail("file is truncated");
+        return n_keys;
+    }
+
+    /**
+     * Decompresses the complete frames in the @p src_size bytes at @p src, whose decompressed bytes start at @p offset
+     * of the decompressed file. Decompressed bytes of the header are dropped, the others are written to their position
+     * in @p dst, which holds the @p dst_size bytes following the header.
+     * @param src compressed frames
+     * @param src_size size of the compressed frames in bytes
+     * @param offset offset of the decompressed frames in the decompressed file
+     * @param dst bytes following the header
+     * @param dst_size number of bytes following the header
+     * @return offset in the decompressed file following the decompressed frames
+     */
+    std::size_t decompress_frames(const char *src, const std::size_t src_size, const std::size_t offset, char *dst,
+                           const std::size_t dst_size) const {
+        std::uint64_t header;
+        ZSTD_DCtx *dctx = create_context();
+        ZSTD_inBuffer in{src, src_size, 0};
+        ZSTD_outBuffer out = offset < header_size ? ZSTD_outBuffer{&header, header_size, offset}
+                                                  : ZSTD_outBuffer{dst, dst_size, offset - header_size};
+        std::size_t ret;
+        do {
+            const std::size_t in_pos = in.pos, out_pos = out.pos;
+            ret = ZSTD_decompressStream(dctx, &out, &in);
+            if (ZSTD_isError(ret)) fail(ZSTD_getErrorName(ret));
+            if (out.dst == &header and out.pos == out.size) // header is complete, continue with keys
+                out = ZSTD_outBuffer{dst, dst_size, 0};
+            else if (in.pos == in_pos and out.pos == out_pos) // no progress, keys are full or last frame is incomplete
+                fail(in.pos == in.size ? "file is truncated" : "size does not match the number of keys");
+        } while (in.pos != in.size or ret != 0);
+        ZSTD_freeDCtx(dctx);
+        return out.dst == &header ? out.pos : header_size + out.pos;
+    }
+};
+#endif
+
+/**
+ * Reads a dataset file @p filename in binary format and writes keys to vector. Files ending with `.zst` are
+ * decompressed while reading, see ZstdFile.
  * @tparam Key the type of the key
  * @param filename name of the dataset file
  * @return vector of keys
@@ -164,6 +467,19 @@ template<typename Key>
 std::vector<Key> load_data(const std::string &filename) {
     using key_type = Key;
 
+    // Decompress file.
+    if (is_zstd_file(filename)) {
+#if RMI_ZSTD
+        ZstdFile file(filename);
+        std::vector<key_type> data(file.n_keys());
+        file.decompress(data.data(), data.size());
+        return data;
+#else
+        std::cerr << "Could not load " << filename << ": compiled without zstd support." << std::endl;
+        exit(EXIT_FAILURE);
+#endif
+    }
+
     // Open file.
     std::ifstream in(filename, std::ios::binary);
     if (!in.is_open()) {
@@ -185,3 +501,26 @@ std::vector<Key> load_data(const std::string &filename) {
 
     return data;
 }
+
+/**
+ * Reads a dataset file @p filename in text format with one key per line and writes keys to vector.
+ * @param filename name of the dataset file
+ * @return vector of keys
+ */
+inline std::vector<std::string> load_strings(const std::string &filename) {
+    // Open file.
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        std::cerr << "Could not load " << filename << '.' << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read keys.
+    std::vector<std::string> data;
+    std::string line;
+    while (std::getline(in, line))
+        data.push_back(line);
+    in.close();
+
+    return data;
+}
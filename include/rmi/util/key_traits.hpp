@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace rmi {
+
+/**
+ * 128-bit integer types. They are a GCC and Clang extension, so `__extension__` keeps `-pedantic` from warning about
+ * every use.
+ */
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+/**
+ * Order-preserving transform of keys to unsigned integers of the same width, i.e., `a < b` if and only if
+ * `encode(a) < encode(b)`. Models that operate on the bit representation of keys, e.g., Radix, work on encoded keys
+ * so that they support signed integers and floating-point numbers.
+ *
+ * Supported key types are unsigned and signed integers of up to 64 bits, `float`, `double`, and 128-bit integers.
+ *
+ * @tparam Key the type of the keys
+ */
+template<typename Key, typename = void>
+struct key_traits;
+
+/**
+ * Unsigned integers are their own encoding.
+ */
+template<typename Key>
+struct key_traits<Key, std::enable_if_t<std::is_integral<Key>::value and std::is_unsigned<Key>::value>>
+{
+    using encoded_type = Key;
+    static encoded_type encode(const Key key) { return key; }
+};
+
+/**
+ * Signed integers are encoded by flipping the sign bit, which maps the smallest value to zero.
+ */
+template<typename Key>
+struct key_traits<Key, std::enable_if_t<std::is_integral<Key>::value and std::is_signed<Key>::value>>
+{
+    using encoded_type = std::make_unsigned_t<Key>;
+    static encoded_type encode(const Key key) {
+        return static_cast<encoded_type>(key) ^ (encoded_type(1) << (sizeof(Key) * 8 - 1));
+    }
+};
+
+/**
+ * Unsigned 128-bit integers are their own encoding.
+ */
+template<>
+struct key_traits<uint128_t>
+{
+    using encoded_type = uint128_t;
+    static encoded_type encode(const uint128_t key) { return key; }
+};
+
+/**
+ * Signed 128-bit integers are encoded by flipping the sign bit.
+ */
+template<>
+struct key_traits<int128_t>
+{
+    using encoded_type = uint128_t;
+    static encoded_type encode(const int128_t key) {
+        return static_cast<encoded_type>(key) ^ (encoded_type(1) << 127);
+    }
+};
+
+/**
+ * Floating-point numbers are encoded by flipping the sign bit of non-negative numbers and all bits of negative
+ * numbers, which orders negative numbers by descending magnitude before non-negative numbers.
+ */
+template<typename Key>
+struct key_traits<Key, std::enable_if_t<std::is_floating_point<Key>::value>>
+{
+    static_assert(sizeof(Key) == 4 or sizeof(Key) == 8, "only float and double are supported");
+    using encoded_type = std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+    static encoded_type encode(const Key key) {
+        encoded_type bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+        constexpr encoded_type sign = encoded_type(1) << (sizeof(Key) * 8 - 1);
+        return bits & sign ? ~bits : bits | sign;
+    }
+};
+
+
+/**
+ * Returns the difference @p x - @p base of two keys as `double`. For integers, the difference is computed exactly
+ * before it is converted, so no precision is lost for keys beyond 2^53 that are close to each other, and signed keys
+ * cannot overflow.
+ * @tparam Key the type of the keys
+ * @param base the key to subtract
+ * @param x the key to subtract from
+ * @return the difference of the keys
+ */
+template<typename Key>
+double key_delta(const Key base, const Key x)
+{
+    if constexpr (std::is_floating_point<Key>::value) {
+        return static_cast<double>(x) - static_cast<double>(base);
+    } else {
+        auto b = key_traits<Key>::encode(base);
+        auto e = key_traits<Key>::encode(x);
+        return e >= b ? static_cast<double>(e - b) : -static_cast<double>(b - e);
+    }
+}
+
+} // namespace rmi
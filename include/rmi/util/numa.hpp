@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+
+namespace rmi {
+
+/**
+ * Parses a CPU or node list in the format used by sysfs, e.g., `0-3,8-11`.
+ * @param list the list to parse
+ * @return the ids in the list
+ */
+inline std::vector<int> parse_id_list(const std::string &list)
+{
+    std::vector<int> ids;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int id = first; id <= last; ++id)
+            ids.push_back(id);
+    }
+    return ids;
+}
+
+/**
+ * NUMA topology of the machine as reported by sysfs. Nodes are numbered consecutively from zero in the order of their
+ * ids, which need not be consecutive. Machines without NUMA support are reported as a single node holding all CPUs.
+ */
+class NumaTopology
+{
+    private:
+    std::vector<std::vector<int>> cpus_; ///< The CPUs of each node.
+    std::vector<std::size_t> node_of_;   ///< The node of each CPU.
+
+    NumaTopology() {
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string list;
+        if (std::getline(online, list)) {
+            for (int id : parse_id_list(list)) {
+                std::ifstream in("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+                std::string cpus;
+                if (std::getline(in, cpus) and not parse_id_list(cpus).empty()) // skip memory-only nodes
+                    cpus_.push_back(parse_id_list(cpus));
+            }
+        }
+        if (cpus_.empty()) {
+            cpus_.emplace_back();
+            for (unsigned cpu = 0; cpu != std::max(std::thread::hardware_concurrency(), 1u); ++cpu)
+                cpus_.back().push_back(cpu);
+        }
+        for (std::size_t node = 0; node != cpus_.size(); ++node) {
+            for (int cpu : cpus_[node]) {
+                if (node_of_.size() <= std::size_t(cpu)) node_of_.resize(cpu + 1, 0);
+                node_of_[cpu] = node;
+            }
+        }
+    }
+
+    public:
+    /**
+     * Returns the topology of this machine, which is read once.
+     * @return the topology
+     */
+    static const NumaTopology & get() {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    /**
+     * Returns the number of nodes.
+     * @return the number of nodes
+     */
+    std::size_t n_nodes() const { return cpus_.size(); }
+
+    /**
+     * Returns the CPUs of node @p node.
+     * @param node the node
+     * @return the CPUs of the node
+     */
+    const std::vector<int> & cpus(const std::size_t node) const { return cpus_[node]; }
+
+    /**
+     * Returns the node of CPU @p cpu.
+     * @param cpu the CPU
+     * @return the node of the CPU
+     */
+    std::size_t node_of(const int cpu) const {
+        return cpu >= 0 and std::size_t(cpu) < node_of_.size() ? node_of_[cpu] : 0;
+    }
+
+    /**
+     * Returns the node the calling thread is currently running on.
+     * @return the node of the calling thread
+     */
+    std::size_t current_node() const { return node_of(sched_getcpu()); }
+};
+
+/**
+ * Restricts the calling thread to the CPUs @p cpus.
+ * @param cpus the CPUs the thread may run on
+ */
+inline void pin_thread(const std::vector<int> &cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+        CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * Restricts the calling thread to the CPUs of NUMA node @p node.
+ * @param node the node the thread may run on
+ */
+inline void pin_thread_to_node(const std::size_t node) { pin_thread(NumaTopology::get().cpus(node)); }
+
+
+/**
+ * Holds one replica of an object per NUMA node, e.g., an index or the keys it was built on, so that threads access
+ * local memory only.
+ *
+ * Each replica is constructed by a thread pinned to its node. Since Linux places pages on the node of the thread that
+ * first touches them, all memory allocated and initialized during construction, e.g., the layer2 models and error
+ * bounds of an index, is local to the node. Replicas are never modified afterwards and may be read concurrently.
+ *
+ * @tparam T the type of the replicated object
+ */
+template<typename T>
+class Replicated
+{
+    private:
+    std::vector<std::unique_ptr<T>> replicas_; ///< The replica of each node.
+
+    public:
+    /**
+     * Constructs one replica per NUMA node from @p args. The replicas are constructed concurrently.
+     * @param args arguments passed to the constructor of each replica
+     */
+    template<typename... Args>
+    explicit Replicated(const Args&... args) : replicas_(NumaTopology::get().n_nodes()) {
+        std::vector<std::thread> threads;
+        for (std::size_t node = 0; node != replicas_.size(); ++node) {
+            threads.emplace_back([&, node]() {
+                pin_thread_to_node(node);
+                replicas_[node] = std::make_unique<T>(args...);
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+    }
+
+    /**
+     * Returns the replica on the node the calling thread is running on. Threads should be pinned to a node, otherwise
+     * they may migrate to another node while using the replica.
+     * @return the local replica
+     */
+    const T & local() const { return *replicas_[NumaTopology::get().current_node()]; }
+
+    /**
+     * Returns the replica on node @p node.
+     * @param node the node
+     * @return the replica on the node
+     */
+    const T & on_node(const std::size_t node) const { return *replicas_[node]; }
+
+    /**
+     * Returns the number of replicas.
+     * @return the number of replicas
+     */
+    std::size_t size() const { return replicas_.size(); }
+};
+
+} // namespace rmi
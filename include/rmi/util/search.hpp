@@ -99,6 +99,42 @@ struct ModelBiasedBinarySearch {
 };
 
 
+/**
+ * Functor for performing binary search that finishes with a branch-free scan once the remaining interval fits into a
+ * cache line. A cache line holds 64 / sizeof(T) elements, so narrow keys need fewer halving steps and fewer cache
+ * lines, e.g., 32-bit keys scan 16 elements per line at half the memory bandwidth of 64-bit keys.
+ */
+struct CachelineBinarySearch {
+    /**
+     * Performs binary search in the interval [first,last) to find the first element that is not less than @t value.
+     * @tparam InputIt input iterator type
+     * @tparam T type of searched value
+     * @param first, last iterators defining the partially-ordered range to examine
+     * @param pred iterator to the predicted position (ignored)
+     * @param value value to compare the elements to
+     * @return iterator to the first element that is not less than @p value
+     */
+    template<typename InputIt, typename T>
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+        constexpr std::size_t line = std::max<std::size_t>(64 / sizeof(T), 1); // elements per cache line
+        std::size_t n = std::distance(first, last);
+        while (n > line) {
+            std::size_t half = n / 2;
+            if (*(first + half) < value) {
+                first += half + 1;
+                n -= half + 1;
+            } else {
+                n = half;
+            }
+        }
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i != n; ++i)
+            pos += *(first + i) < value; // no branch, compiled to vector compares
+        return first + pos;
+    }
+};
+
+
 /**
  * Functor for performing exponential search.
  */
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace rmi {
+
+/**
+ * Alignment of the sections of a serialized index in bytes. Sections are aligned to a cache line so that arrays can be
+ * used in place after mapping the file into memory.
+ */
+constexpr std::size_t file_alignment = 64;
+
+/**
+ * Writes an index to a binary file section by section. Write errors, e.g., a full disk, are reported and terminate the
+ * program, so that no truncated index file is left behind silently.
+ */
+class Writer
+{
+    private:
+    std::ofstream out_;    ///< The output file stream.
+    std::size_t offset_;   ///< The number of bytes written so far.
+    std::string filename_; ///< The name of the file.
+
+    public:
+    /**
+     * Creates the file @p filename, overwriting any existing file.
+     * @param filename name of the file to write to
+     */
+    explicit Writer(const std::string &filename)
+        : out_(filename, std::ios::binary | std::ios::trunc), offset_(0), filename_(filename) {
+        if (!out_.is_open()) {
+            std::cerr << "Could not write " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Writer(const Writer&) = delete;
+    Writer & operator=(const Writer&) = delete;
+
+    /**
+     * Closes the file if #close() has not been called yet.
+     */
+    ~Writer() { if (out_.is_open()) close(); }
+
+    /**
+     * Flushes the remaining bytes and closes the file.
+     */
+    void close() {
+        out_.close();
+        check();
+    }
+
+    /**
+     * Writes @p n bytes starting at @p data.
+     * @param data pointer to the bytes to be written
+     * @param n number of bytes to be written
+     */
+    void write(const void *data, const std::size_t n) {
+        out_.write(reinterpret_cast<const char*>(data), n);
+        check();
+        offset_ += n;
+    }
+
+    /**
+     * Writes the object representation of @p value.
+     * @tparam T the type of the value, must be trivially copyable
+     * @param value to be written
+     */
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+        write(&value, sizeof(T));
+    }
+
+    /**
+     * Pads the file with zero bytes up to the next multiple of #file_alignment.
+     */
+    void align() {
+        static const char zeros[file_alignment] = { };
+        write(zeros, (file_alignment - offset_ % file_alignment) % file_alignment);
+    }
+
+    private:
+    /**
+     * Reports a failed write and terminates.
+     */
+    void check() const {
+        if (!out_) {
+            std::cerr << "Could not write " << filename_ << ": " << std::strerror(errno) << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+};
+
+/**
+ * Reads an index from a binary file that is mapped into memory. Sections are not copied, instead pointers into the
+ * mapping are returned. The mapping is released once the reader and all copies of #mapping() are destroyed.
+ */
+class Reader
+{
+    private:
+    std::shared_ptr<const unsigned char> mapping_; ///< The memory mapping of the file.
+    std::size_t size_;                             ///< The size of the file in bytes.
+    std::size_t offset_;                           ///< The number of bytes read so far.
+    std::string filename_;                         ///< The name of the file.
+
+    public:
+    /**
+     * Maps the file @p filename into memory.
+     * @param filename name of the file to read from
+     */
+    explicit Reader(const std::string &filename) : size_(0), offset_(0), filename_(filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 or fstat(fd, &st) != 0 or st.st_size == 0) {
+            std::cerr << "Could not load " << filename << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        size_ = st.st_size;
+        void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping stays valid after closing the file
+        if (addr == MAP_FAILED) {
+            std::cerr << "Could not map " << filename << " into memory." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        const std::size_t size = size_;
+        mapping_ = std::shared_ptr<const unsigned char>(static_cast<const unsigned char*>(addr),
+                                                        [size](const unsigned char *p) {
+            munmap(const_cast<unsigned char*>(p), size);
+        });
+    }
+
+    /**
+     * Reports that the file is malformed and terminates.
+     */
+    [[noreturn]] void fail() const {
+        std::cerr << "Could not load " << filename_ << ": malformed index file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /**
+     * Returns a pointer to the next @p n bytes of the file and advances past them.
+     * @param n number of bytes to be read
+     * @return pointer to the bytes inside the mapping
+     */
+    const void * read(const std::size_t n) {
+        if (n > size_ - offset_) fail();
+        const void *data = mapping_.get() + offset_;
+        offset_ += n;
+        return data;
+    }
+
+    /**
+     * Reads a value of type @p T by copying its object representation.
+     * @tparam T the type of the value, must be trivially copyable
+     * @return the value
+     */
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+        T value;
+        std::memcpy(&value, read(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * Reads @p expected and terminates if the file holds a different value, e.g., a different format version.
+     * @tparam T the type of the value, must be trivially copyable
+     * @param expected the expected value
+     */
+    template<typename T>
+    void expect(const T &expected) {
+        if (read<T>() != expected) fail();
+    }
+
+    /**
+     * Skips the padding up to the next multiple of #file_alignment.
+     */
+    void align() {
+        std::size_t padding = (file_alignment - offset_ % file_alignment) % file_alignment;
+        if (padding > size_ - offset_) fail();
+        offset_ += padding;
+    }
+
+    /**
+     * Returns a handle that keeps the mapping alive.
+     * @return handle to the mapping
+     */
+    std::shared_ptr<const void> mapping() const { return mapping_; }
+};
+
+} // namespace rmi
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <x86intrin.h>
+
+#include "rmi/models.hpp"
+#include "rmi/util/fn.hpp"
+
+/**
+ * The number of 64-bit lanes the SIMD kernels evaluate at once, i.e., 8 with AVX-512 (F and DQ), 4 with AVX2 and FMA,
+ * and 1 otherwise. Define `RMI_SIMD_WIDTH=1` to fall back to scalar evaluation, e.g., for comparison.
+ */
+#ifndef RMI_SIMD_WIDTH
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+#define RMI_SIMD_WIDTH 8
+#elif defined(__AVX2__) && defined(__FMA__)
+#define RMI_SIMD_WIDTH 4
+#else
+#define RMI_SIMD_WIDTH 1
+#endif
+#endif
+
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Vector Operations
+ *====================================================================================================================*/
+
+#if RMI_SIMD_WIDTH == 8
+
+/**
+ * Vector operations on eight 64-bit lanes using AVX-512.
+ */
+struct Simd
+{
+    using vec = __m512d;  ///< Vector of doubles.
+    using ivec = __m512i; ///< Vector of 64-bit integers.
+
+    static constexpr std::size_t width = 8; ///< The number of lanes.
+
+    static ivec load(const std::uint64_t *p) { return _mm512_loadu_si512(p); }
+    static vec set1(const double v) { return _mm512_set1_pd(v); }
+    static vec to_double(const ivec x) { return _mm512_cvtepu64_pd(x); }
+    static vec fma(const vec a, const vec b, const vec c) { return _mm512_fmadd_pd(a, b, c); }
+    // The unmasked forms of gather, min, and max pass `_mm512_undefined_pd()` as source, which GCC 12 flags with
+    // -Wmaybe-uninitialized once inlined (GCC bug 105593). The masked forms with a zero source avoid the warning and
+    // compile to the same instructions.
+    static vec gather(const double *base, const ivec idx) {
+        return _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xff, idx, base, 8);
+    }
+
+    /**
+     * Clamps the lanes of @p v to [0, @p max], truncates them to integers, and stores them to @p out.
+     */
+    static void store_clamped(const vec v, const double max, std::uint64_t *out) {
+        const vec zero = _mm512_setzero_pd();
+        vec c = _mm512_mask_max_pd(zero, 0xff, v, zero);
+        c = _mm512_mask_min_pd(zero, 0xff, c, _mm512_set1_pd(max));
+        _mm512_storeu_si512(out, _mm512_cvttpd_epu64(c));
+    }
+};
+
+#elif RMI_SIMD_WIDTH == 4
+
+/**
+ * Vector operations on four 64-bit lanes using AVX2. AVX2 lacks conversions between 64-bit integers and doubles, so
+ * they are composed from 32-bit halves and the 2^52 and 2^84 bit patterns of doubles.
+ */
+struct Simd
+{
+    using vec = __m256d;  ///< Vector of doubles.
+    using ivec = __m256i; ///< Vector of 64-bit integers.
+
+    static constexpr std::size_t width = 4; ///< The number of lanes.
+
+    static ivec load(const std::uint64_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static vec set1(const double v) { return _mm256_set1_pd(v); }
+    static vec fma(const vec a, const vec b, const vec c) { return _mm256_fmadd_pd(a, b, c); }
+    static vec gather(const double *base, const ivec idx) { return _mm256_i64gather_pd(base, idx, 8); }
+
+    /**
+     * Converts unsigned 64-bit integers to doubles with a single rounding, like a scalar conversion.
+     */
+    static vec to_double(const ivec x) {
+        ivec hi = _mm256_or_si256(_mm256_srli_epi64(x, 32), _mm256_castpd_si256(_mm256_set1_pd(0x1p84)));
+        ivec lo = _mm256_blend_epi16(x, _mm256_castpd_si256(_mm256_set1_pd(0x1p52)), 0xcc);
+        vec f = _mm256_sub_pd(_mm256_castsi256_pd(hi), _mm256_set1_pd(0x1p84 + 0x1p52));
+        return _mm256_add_pd(f, _mm256_castsi256_pd(lo));
+    }
+
+    /**
+     * Clamps the lanes of @p v to [0, @p max], truncates them to integers, and stores them to @p out. Requires
+     * @p max < 2^52.
+     */
+    static void store_clamped(const vec v, const double max, std::uint64_t *out) {
+        vec c = _mm256_min_pd(_mm256_max_pd(v, _mm256_setzero_pd()), _mm256_set1_pd(max));
+        vec t = _mm256_add_pd(_mm256_round_pd(c, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC), _mm256_set1_pd(0x1p52));
+        ivec r = _mm256_xor_si256(_mm256_castpd_si256(t), _mm256_castpd_si256(_mm256_set1_pd(0x1p52)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), r);
+    }
+};
+
+#endif
+
+
+/*======================================================================================================================
+ * Batched Model Evaluation
+ *====================================================================================================================*/
+
+/**
+ * Evaluates the model @p m on @p n keys and writes the predictions clamped to [0, @p max] to @p out, i.e., the same
+ * values as `clamp_prediction(m.predict(key), max)` for each key.
+ *
+ * LinearSpline, LinearRegression, and CubicSpline on 64-bit unsigned keys are evaluated on #RMI_SIMD_WIDTH keys at
+ * once. Other models, e.g., Radix whose parallel bits extract has no vector form, and remaining keys are evaluated
+ * one key at a time.
+ * @param m the model
+ * @param keys array of keys
+ * @param n number of keys
+ * @param max the largest valid prediction
+ * @param out array to write the predictions to
+ */
+template<typename Model, typename Key>
+void predict_clamped(const Model &m, const Key *keys, const std::size_t n, const std::size_t max, std::size_t *out)
+{
+    std::size_t i = 0;
+#if RMI_SIMD_WIDTH > 1
+    if constexpr (std::is_same<Key, std::uint64_t>::value and sizeof(std::size_t) == sizeof(std::uint64_t)) {
+        auto *res = reinterpret_cast<std::uint64_t*>(out);
+        if constexpr (std::is_same<Model, LinearSpline>::value or std::is_same<Model, LinearRegression>::value) {
+            auto slope = Simd::set1(m.slope());
+            auto intercept = Simd::set1(m.intercept());
+            for (; i + Simd::width <= n; i += Simd::width) {
+                auto x = Simd::to_double(Simd::load(keys + i));
+                Simd::store_clamped(Simd::fma(slope, x, intercept), max, res + i);
+            }
+        } else if constexpr (std::is_same<Model, CubicSpline>::value) {
+            auto a = Simd::set1(m.a());
+            auto b = Simd::set1(m.b());
+            auto c = Simd::set1(m.c());
+            auto d = Simd::set1(m.d());
+            for (; i + Simd::width <= n; i += Simd::width) {
+                auto x = Simd::to_double(Simd::load(keys + i));
+                auto v = Simd::fma(Simd::fma(Simd::fma(a, x, b), x, c), x, d); // Horner scheme like predict()
+                Simd::store_clamped(v, max, res + i);
+            }
+        }
+    }
+#endif
+    for (; i != n; ++i)
+        out[i] = clamp_prediction(m.predict(keys[i]), max);
+}
+
+/**
+ * Evaluates the models @p models[@p model_ids[i]] on @p n keys and writes the predictions clamped to [0, @p max] to
+ * @p out, i.e., the same values as `clamp_prediction(models[model_ids[i]].predict(keys[i]), max)` for each key.
+ *
+ * If the models are linear, i.e., LinearSpline or LinearRegression or a record derived from them such as the records
+ * of InterleavedLayout, slopes and intercepts of #RMI_SIMD_WIDTH models are gathered and evaluated at once. This
+ * relies on the models storing their slope followed by their intercept at the start of each record. Other models and
+ * remaining keys are evaluated one key at a time.
+ * @param models array of models
+ * @param model_ids array of the ids of the models to evaluate per key
+ * @param keys array of keys
+ * @param n number of keys
+ * @param max the largest valid prediction
+ * @param out array to write the predictions to
+ */
+template<typename Model, typename Key>
+void predict_clamped(const Model *models, const std::size_t *model_ids, const Key *keys, const std::size_t n,
+                     const std::size_t max, std::size_t *out)
+{
+    std::size_t i = 0;
+#if RMI_SIMD_WIDTH > 1
+    constexpr bool is_linear = std::is_base_of<LinearSpline, Model>::value or
+                               std::is_base_of<LinearRegression, Model>::value;
+    if constexpr (std::is_same<Key, std::uint64_t>::value and sizeof(std::size_t) == sizeof(std::uint64_t) and
+                  is_linear and sizeof(Model) % sizeof(double) == 0) {
+        static_assert(sizeof(LinearSpline) == 2 * sizeof(double) and sizeof(LinearRegression) == 2 * sizeof(double));
+        constexpr std::size_t stride = sizeof(Model) / sizeof(double);
+        auto *res = reinterpret_cast<std::uint64_t*>(out);
+        const double *base = reinterpret_cast<const double*>(models);
+        for (; i + Simd::width <= n; i += Simd::width) {
+            std::uint64_t offsets[Simd::width];
+            for (std::size_t j = 0; j != Simd::width; ++j)
+                offsets[j] = model_ids[i + j] * stride;
+            auto idx = Simd::load(offsets);
+            auto slope = Simd::gather(base, idx);
+            auto intercept = Simd::gather(base + 1, idx);
+            auto x = Simd::to_double(Simd::load(keys + i));
+            Simd::store_clamped(Simd::fma(slope, x, intercept), max, res + i);
+        }
+    }
+#endif
+    for (; i != n; ++i)
+        out[i] = clamp_prediction(models[model_ids[i]].predict(keys[i]), max);
+}
+
+} // namespace rmi
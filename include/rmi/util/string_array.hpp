@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace rmi {
+
+/**
+ * An immutable array of variable-length strings. The characters of all strings are packed back to back into a single
+ * blob and the strings are delimited by an array of offsets into the blob, so that the array occupies two allocations
+ * regardless of the number of strings and consecutive strings are adjacent in memory.
+ */
+class StringArray
+{
+    private:
+    std::vector<char> blob_;             ///< The characters of all strings.
+    std::vector<std::uint64_t> offsets_; ///< The offset of each string into #blob_ followed by the size of #blob_.
+
+    public:
+    /**
+     * Random-access iterator over the strings of the array that yields `std::string_view`s into the blob.
+     */
+    class const_iterator
+    {
+        private:
+        const StringArray *array_ = nullptr; ///< The array iterated over.
+        std::ptrdiff_t i_ = 0;               ///< The index of the current string, signed like a pointer.
+
+        public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        const_iterator() = default;
+        const_iterator(const StringArray *array, const std::ptrdiff_t i) : array_(array), i_(i) { }
+
+        std::string_view operator*() const { return (*array_)[i_]; }
+        std::string_view operator[](const difference_type n) const { return (*array_)[i_ + n]; }
+
+        const_iterator & operator++() { ++i_; return *this; }
+        const_iterator & operator--() { --i_; return *this; }
+        const_iterator operator++(int) { auto tmp = *this; ++i_; return tmp; }
+        const_iterator operator--(int) { auto tmp = *this; --i_; return tmp; }
+        const_iterator & operator+=(const difference_type n) { i_ += n; return *this; }
+        const_iterator & operator-=(const difference_type n) { i_ -= n; return *this; }
+        const_iterator operator+(const difference_type n) const { return {array_, i_ + n}; }
+        const_iterator operator-(const difference_type n) const { return {array_, i_ - n}; }
+        friend const_iterator operator+(const difference_type n, const const_iterator &it) { return it + n; }
+        difference_type operator-(const const_iterator &other) const { return i_ - other.i_; }
+
+        bool operator==(const const_iterator &other) const { return i_ == other.i_; }
+        bool operator!=(const const_iterator &other) const { return i_ != other.i_; }
+        bool operator<(const const_iterator &other) const { return i_ < other.i_; }
+        bool operator>(const const_iterator &other) const { return i_ > other.i_; }
+        bool operator<=(const const_iterator &other) const { return i_ <= other.i_; }
+        bool operator>=(const const_iterator &other) const { return i_ >= other.i_; }
+    };
+
+    /**
+     * Default constructor.
+     */
+    StringArray() : offsets_(1, 0) { }
+
+    /**
+     * Packs the strings in the range [first, last) into an array.
+     * @param first, last iterators that define the range of strings
+     */
+    template<typename InputIt>
+    StringArray(InputIt first, InputIt last) : offsets_(1, 0) {
+        for (; first != last; ++first) {
+            std::string_view s(*first);
+            blob_.insert(blob_.end(), s.begin(), s.end());
+            offsets_.push_back(blob_.size());
+        }
+        blob_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+    }
+
+    /**
+     * Packs the @p strings into an array.
+     * @param strings the strings
+     */
+    explicit StringArray(const std::vector<std::string> &strings) : StringArray(strings.begin(), strings.end()) { }
+
+    /**
+     * Returns the string at position @p i.
+     * @param i the position
+     * @return the string at position @p i
+     */
+    std::string_view operator[](const std::size_t i) const {
+        return {blob_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+    }
+
+    /**
+     * Returns an iterator to the first string.
+     * @return iterator to the first string
+     */
+    const_iterator begin() const { return {this, 0}; }
+
+    /**
+     * Returns an iterator past the last string.
+     * @return iterator past the last string
+     */
+    const_iterator end() const { return {this, static_cast<std::ptrdiff_t>(size())}; }
+
+    /**
+     * Returns the number of strings.
+     * @return the number of strings
+     */
+    std::size_t size() const { return offsets_.size() - 1; }
+
+    /**
+     * Returns whether the array holds no strings.
+     * @return whether the array is empty
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * Returns the size of the array in bytes, i.e., the size of the blob and the offsets.
+     * @return array size in bytes
+     */
+    std::size_t size_in_bytes() const { return blob_.size() + offsets_.size() * sizeof(std::uint64_t); }
+};
+
+} // namespace rmi
@@ -20,5 +20,29 @@ python3 scripts/plot_rmi_build.py
 echo "Plotting RMI Guideline (Section 8)..."
 python3 scripts/plot_rmi_guideline.py
 
+echo "Plotting RMI Depth..."
+python3 scripts/plot_rmi_depth.py
+
+echo "Plotting RMI Update..."
+python3 scripts/plot_rmi_update.py
+
+echo "Plotting RMI NUMA..."
+python3 scripts/plot_rmi_numa.py
+
+echo "Plotting RMI Key Types..."
+python3 scripts/plot_rmi_key_types.py
+
+echo "Plotting String Comparison..."
+python3 scripts/plot_string_comparison.py
+
+echo "Plotting RMI Map..."
+python3 scripts/plot_rmi_map.py
+
+echo "Plotting RMI Range..."
+python3 scripts/plot_rmi_range.py
+
+echo "Plotting RMI Duplicates..."
+python3 scripts/plot_rmi_duplicates.py
+
 echo "Plotting Index Comparison (Section 9)..."
 python3 scripts/plot_index_comparison.py
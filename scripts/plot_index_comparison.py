@@ -224,7 +224,8 @@ if __name__ == "__main__":
         'RadixSpline': 'RadixSpline',
         'Compact Hist-Tree': 'Hist-Tree',
         'B-tree': 'B-tree',
-        'ART': 'ART'
+        'ART': 'ART',
+        'RMI-ours-simd': 'RMI (ours, SIMD)'
     }
 
     # Compute metrics
@@ -219,6 +219,93 @@ def plot_comp(dataset, models, bound, filename):
     fig.savefig(os.path.join(path, filename), bbox_inches='tight')
 
 
+def plot_threads(filename='rmi_build-threads.pdf'):
+    rmi = 'ours'
+    l1, l2 = 'LS', 'LR'
+
+    n_cols = len(datasets)
+    n_rows = 1
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(2.7*n_cols, 2.3*n_rows), sharey=True, squeeze=False)
+    fig.tight_layout()
+
+    for col, dataset in enumerate(datasets):
+        ax = axs[0,col]
+        for bound in bounds:
+            data = df_threads[
+                    (df_threads['dataset']==dataset) &
+                    (df_threads['rmi']==rmi) &
+                    (df_threads['layer1']==l1) &
+                    (df_threads['layer2']==l2) &
+                    (df_threads['bounds']==bound)
+            ]
+            if not data.empty:
+                sequential = data[data['n_threads']==1]['build_in_s']
+                if sequential.empty:
+                    continue
+                ax.plot(data['n_threads'], sequential.iloc[0] / data['build_in_s'], c=bound_colors[bound], marker='.', label=bound)
+
+        # Title
+        ax.set_title(f'{dataset} ({l1}$\mapsto${l2})')
+
+        # Labels
+        if col == 0:
+            ax.set_ylabel('Speedup')
+        ax.set_xlabel('Threads')
+
+        # Axes
+        ax.set_xscale('log', base=2)
+        ax.set_ylim(bottom=0)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(bounds), bbox_to_anchor=(0.5, 1), loc='lower center')
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+def plot_sampling(filename='rmi_build-sampling.pdf'):
+    l1, l2 = 'LS', 'LR'
+
+    n_cols = len(datasets)
+    n_rows = 1
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(2.7*n_cols, 2.3*n_rows), sharey=True, squeeze=False)
+    fig.tight_layout()
+
+    for col, dataset in enumerate(datasets):
+        ax = axs[0,col]
+        for rmi in ['ours', 'ours_stream']:
+            for bound in bounds:
+                data = df_sampling[
+                        (df_sampling['dataset']==dataset) &
+                        (df_sampling['rmi']==rmi) &
+                        (df_sampling['layer1']==l1) &
+                        (df_sampling['layer2']==l2) &
+                        (df_sampling['bounds']==bound)
+                ].sort_values('sample_rate')
+                if not data.empty:
+                    ax.plot(data['mean_log2_error'], data['build_in_s'], c=bound_colors[bound], marker=rmi_markers[rmi],
+                            label=f'{bound} ({rmi})')
+
+        # Title
+        ax.set_title(f'{dataset} ({l1}$\mapsto${l2})')
+
+        # Labels
+        if col == 0:
+            ax.set_ylabel('Build time [s]')
+        ax.set_xlabel('Mean log2 error')
+
+        # Axes
+        ax.set_ylim(bottom=0)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(bounds), bbox_to_anchor=(0.5, 1), loc='lower center')
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
 if __name__ == "__main__":
     path = 'results'
 
@@ -226,8 +313,22 @@ if __name__ == "__main__":
     file = os.path.join(path, 'rmi_build.csv')
     df = pd.read_csv(file, delimiter=',', header=0, comment='#')
 
+    # Separate multi-threaded builds
+    if 'n_threads' not in df:
+        df['n_threads'] = 1
+    if 'sample_rate' not in df:
+        df['sample_rate'] = 1
+    if 'mean_log2_error' not in df:
+        df['mean_log2_error'] = float('nan')
+    df_sampling = df[(df['n_models'] == 2**20) & (df['n_threads'] == 1)]
+    df = df[(df['sample_rate'] == 1) & (df['rmi'] != 'ours_stream')]
+    df_threads = df[df['n_models'] == 2**20]
+    df = df[df['n_threads'] == 1]
+
     # Compute median of lookup times
     df = df.groupby(['dataset','rmi','layer1','layer2','n_models','bounds']).median().reset_index()
+    df_threads = df_threads.groupby(['dataset','rmi','layer1','layer2','n_models','bounds','n_threads']).median().reset_index()
+    df_sampling = df_sampling.groupby(['dataset','rmi','layer1','layer2','n_models','bounds','sample_rate']).median().reset_index()
 
     # Replace datasets, model names, and bounds
     dataset_dict = {
@@ -250,10 +351,14 @@ if __name__ == "__main__":
         "none": "NB"
     }
     df.replace({**dataset_dict, **model_dict, **bounds_dict}, inplace=True)
+    df_threads.replace({**dataset_dict, **model_dict, **bounds_dict}, inplace=True)
+    df_sampling.replace({**dataset_dict, **model_dict, **bounds_dict}, inplace=True)
 
     # Compute metrics
     df['size_in_MiB'] = df['size_in_bytes'] / (1024 * 1024)
     df['build_in_s'] = df['build_time'] / 1_000_000_000
+    df_threads['build_in_s'] = df_threads['build_time'] / 1_000_000_000
+    df_sampling['build_in_s'] = df_sampling['build_time'] / 1_000_000_000
 
     # Define variable lists
     datasets = sorted(df['dataset'].unique())
@@ -273,7 +378,7 @@ if __name__ == "__main__":
     n_colors = 8
     for i, bound in enumerate(bounds):
         bound_colors[bound] = cmap(i/n_colors)
-    rmi_markers = {'ours': '.', 'ref': 'x'}
+    rmi_markers = {'ours': '.', 'ours_stream': '+', 'ref': 'x'}
 
     if args['paper']:
         # Plot layer1
@@ -310,3 +415,13 @@ if __name__ == "__main__":
         filename = 'rmi_build-comp_full.pdf'
         print(f'Plotting full build time comparison to reference implementation to \'{filename}\'...')
         plot_comp_full(filename)
+
+        # Plot multi-threaded builds
+        filename = 'rmi_build-threads.pdf'
+        print(f'Plotting build time speedup by number of threads to \'{filename}\'...')
+        plot_threads(filename)
+
+        # Plot sampled builds
+        filename = 'rmi_build-sampling.pdf'
+        print(f'Plotting build time versus mean log2 error by sample rate to \'{filename}\'...')
+        plot_sampling(filename)
@@ -0,0 +1,131 @@
+#!python3
+import argparse
+import itertools
+import matplotlib.cm as cm
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_depth(l1, filename='rmi_depth.pdf'):
+    n_rows = len(datasets)
+    n_cols = len(corr_configs)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharey='row', sharex=True, squeeze=False)
+    fig.tight_layout()
+
+    for row, dataset in enumerate(datasets):
+        for col, (bound, search) in enumerate(corr_configs):
+            ax = axs[row,col]
+            for n_layers, layer2_size in depth_configs:
+                data = df[
+                        (df['dataset']==dataset) &
+                        (df['layer1']==l1) &
+                        (df['n_layers']==n_layers) &
+                        (df['layer2_size']==layer2_size) &
+                        (df['bounds']==bound) &
+                        (df['search']==search)
+                ]
+                if not data.empty:
+                    label = f'{n_layers} layers' if n_layers == 2 else f'{n_layers} layers ($2^{{{layer2_size.bit_length() - 1}}}$)'
+                    ax.plot(data['size_in_MiB'], data['lookup_in_ns'], marker='.', label=label, color=depth_colors[(n_layers, layer2_size)])
+
+            # Title
+            ax.set_title(f'{dataset} ({l1}, {bound}+{search})')
+
+            # Labels
+            if row==n_rows-1:
+                ax.set_xlabel('Index size [MiB]')
+            if col==0:
+                ax.set_ylabel('Lookup time [ns]')
+
+            # Visuals
+            ax.set_ylim(bottom=0)
+            ax.set_xscale('log')
+
+    # Legend
+    handles, labels = [], []
+    for ax in axs.flat:
+        for handle, label in zip(*ax.get_legend_handles_labels()):
+            if label not in labels:
+                handles.append(handle)
+                labels.append(label)
+    fig.legend(handles, labels, ncol=len(labels), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_depth.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of lookup times
+    df = df.groupby(['dataset','layer1','layer2','n_layers','layer_sizes','bounds','search']).median().reset_index()
+
+    # Replace datasets, model names, bounds, and searches
+    dataset_dict = {
+        "books_200M_uint64": "books",
+        "fb_200M_uint64": "fb",
+        "osm_cellids_200M_uint64": "osmc",
+        "wiki_ts_200M_uint64": "wiki"
+    }
+    model_dict = {
+        "cubic_spline": "CS",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    bounds_dict = {
+        "labs": "LAbs",
+        "lind": "LInd",
+        "gabs": "GAbs",
+        "gind": "GInd",
+        "none": "NB"
+    }
+    search_dict = {
+        "binary": "Bin",
+        "model_biased_binary": "MBin",
+        "model_biased_exponential": "MExp",
+    }
+    df.replace({**dataset_dict, **model_dict, **bounds_dict, **search_dict}, inplace=True)
+
+    # Compute metrics
+    df['size_in_MiB'] = df['size_in_bytes'] / (1024 * 1024)
+    df['lookup_in_ns'] = df['lookup_time'] / df['n_samples']
+    df['layer2_size'] = df['layer_sizes'].astype(str).str.split(':').str[0].astype(int)
+    df.loc[df['n_layers']==2, 'layer2_size'] = 0
+    df.sort_values('size_in_bytes', inplace=True)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+    l1models = sorted(df['layer1'].unique())
+    corr_configs = [(bound, search) for bound, search in [('NB','MExp'),('LAbs','Bin'),('LInd','MBin')]
+                    if not df[(df['bounds']==bound) & (df['search']==search)].empty]
+    depth_configs = sorted(df[['n_layers','layer2_size']].drop_duplicates().itertuples(index=False, name=None))
+
+    # Set colors
+    depth_colors = {}
+    cmap = cm.get_cmap('tab10')
+    n_colors = 10
+    for i, config in enumerate(depth_configs):
+        depth_colors[config] = cmap(i/n_colors)
+
+    # Plot lookup times by depth
+    for l1 in l1models:
+        filename = f'rmi_depth-{l1}.pdf'
+        print(f'Plotting lookup time by depth to \'{filename}\'...')
+        plot_depth(l1, filename)
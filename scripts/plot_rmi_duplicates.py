@@ -0,0 +1,120 @@
+#!python3
+import argparse
+import matplotlib.cm as cm
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_duplicates(l1, n_models, filename='rmi_duplicates.pdf'):
+    n_cols = len(ops) + 1
+
+    fig, axs = plt.subplots(1, n_cols, figsize=(4*n_cols, 2.7), squeeze=False)
+    fig.tight_layout(w_pad=3)
+
+    data = df[
+            (df['layer1']==l1) &
+            (df['n_models']==n_models)
+    ]
+
+    # Mean interval size
+    ax = axs[0,0]
+    for bound, search in corr_configs:
+        d = data[(data['bounds']==bound) & (data['search']==search) & (data['api']=='rmi') & (data['op']==ops[0])]
+        ax.plot(d['run_length'], d['mean_interval'], marker='.', label=f'{bound}+{search}',
+                color=config_colors[(bound, search)])
+    ax.set_title(f'{l1}, $2^{{{n_models.bit_length() - 1}}}$ models')
+    ax.set_xlabel('Mean run length')
+    ax.set_ylabel('Mean interval size')
+    ax.set_xscale('log', base=2)
+    ax.set_yscale('log')
+
+    # Lookup times
+    for col, op in enumerate(ops, start=1):
+        ax = axs[0,col]
+        for bound, search in corr_configs:
+            d = data[(data['bounds']==bound) & (data['search']==search) & (data['api']=='rmi') & (data['op']==op)]
+            ax.plot(d['run_length'], d['lookup_time_per_key'], marker='.', label=f'{bound}+{search}',
+                    color=config_colors[(bound, search)])
+        d = data[(data['api']=='binary') & (data['op']==op)].groupby('run_length').median().reset_index()
+        ax.plot(d['run_length'], d['lookup_time_per_key'], marker='', linestyle=':', label='binary search',
+                color='black')
+        ax.set_title(f'{op} ({l1}, $2^{{{n_models.bit_length() - 1}}}$ models)')
+        ax.set_xlabel('Mean run length')
+        ax.set_ylabel('Lookup time [ns]')
+        ax.set_ylim(bottom=0)
+        ax.set_xscale('log', base=2)
+
+    # Legend
+    handles, labels = axs[0,1].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(labels), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_duplicates.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of times
+    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','api','op']).median().reset_index()
+
+    # Replace model names
+    model_dict = {
+        "cubic_spline": "CS",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    search_dict = {
+        "binary": "Bin",
+        "model_biased_binary": "MBin",
+        "model_biased_exponential": "MExp",
+    }
+    bound_dict = {
+        "none": "NB",
+        "labs": "LAbs",
+        "lind": "LInd",
+        "gabs": "GAbs",
+        "gind": "GInd",
+    }
+    df.replace({**model_dict, **search_dict, **bound_dict}, inplace=True)
+
+    # Compute metrics
+    df['run_length'] = df['n_keys'] / df['n_distinct']
+    df['lookup_time_per_key'] = df['lookup_time'] / df['n_samples']
+    df.sort_values('run_length', inplace=True)
+
+    # Define variable lists
+    l1models = sorted(df['layer1'].unique())
+    n_models_list = sorted(df['n_models'].unique())
+    corr_configs = sorted(df[['bounds','search']].drop_duplicates().itertuples(index=False, name=None))
+    ops = sorted(df['op'].unique(), reverse=True)
+
+    # Set colors
+    config_colors = {}
+    cmap = cm.get_cmap('tab10')
+    n_colors = 10
+    for i, config in enumerate(corr_configs):
+        config_colors[config] = cmap(i/n_colors)
+
+    # Plot interval sizes and lookup times by run length
+    for l1 in l1models:
+        for n_models in n_models_list:
+            filename = f'rmi_duplicates-{l1}-{n_models}.pdf'
+            print(f'Plotting interval sizes and lookup times by run length to \'{filename}\'...')
+            plot_duplicates(l1, int(n_models), filename)
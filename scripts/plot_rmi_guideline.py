@@ -31,13 +31,16 @@ def plot_guideline(filename='rmi_guideline.pdf', width_fact=5, height_fact=4.2):
         fast_sizes = list()
         guide_lookups = list()
         guide_sizes = list()
+        tuned_lookups = list()
+        tuned_sizes = list()
         for budget in budgets:
 
             # Fastest configuration
             fast_confs = df[
                 (df['dataset']==dataset) &
                 (df['budget_in_bytes']==budget) &
-                (df['is_guideline']==False)
+                (df['is_guideline']==False) &
+                (df['is_tuned']==False)
             ]
             fast_lookup = fast_confs['lookup_in_ns'].min()
             fast_conf = fast_confs[fast_confs['lookup_in_ns']==fast_lookup]
@@ -58,9 +61,22 @@ def plot_guideline(filename='rmi_guideline.pdf', width_fact=5, height_fact=4.2):
             guide_lookups.append(guide_lookup)
             guide_sizes.append(guide_size)
 
+            # Tuned configuration
+            tuned_conf = df[
+                (df['dataset']==dataset) &
+                (df['budget_in_bytes']==budget) &
+                (df['is_tuned']==True)
+            ]
+            tuned_lookup = tuned_conf['lookup_in_ns'].iloc[0]
+            tuned_size = tuned_conf['size_in_bytes'].iloc[0]
+
+            tuned_lookups.append(tuned_lookup)
+            tuned_sizes.append(tuned_size)
+
         # Plot lookup times
         ax.plot(fast_sizes, fast_lookups, marker='+', markersize=5, c=colors['fastest'], label='RMI (fastest)')
         ax.plot(guide_sizes, guide_lookups, c=colors['guideline'], linestyle='dotted', label='RMI (guideline)')
+        ax.plot(tuned_sizes, tuned_lookups, c=colors['tuned'], linestyle='dashed', label='RMI (tuned)')
 
         # Title
         ax.set_title(f'{dataset}')
@@ -77,7 +93,7 @@ def plot_guideline(filename='rmi_guideline.pdf', width_fact=5, height_fact=4.2):
 
         # Legend
         if col==0:
-            fig.legend(ncol=2, bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+            fig.legend(ncol=3, bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
 
     fig.savefig(os.path.join(path, filename), bbox_inches='tight')
 
@@ -90,7 +106,7 @@ if __name__ == "__main__":
     df = pd.read_csv(file, delimiter=',', header=0, comment='#')
 
     # Compute median of lookup times
-    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','is_guideline']).median().reset_index()
+    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','is_guideline','is_tuned']).median().reset_index()
 
     # Replace datasets
     dataset_dict = {
@@ -113,7 +129,7 @@ if __name__ == "__main__":
     colors = {}
     cmap = cm.get_cmap('tab10')
     n_colors = 8
-    for i, x in enumerate(['fastest', 'guideline']):
+    for i, x in enumerate(['fastest', 'guideline', 'tuned']):
         colors[x] = cmap((i)/n_colors)
 
     if args['paper']:
@@ -0,0 +1,102 @@
+#!python3
+import argparse
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_key_types(l1, l2, filename='rmi_key_types.pdf'):
+    n_rows = len(configs)
+    n_cols = len(datasets)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharex=True, sharey=True, squeeze=False)
+    fig.tight_layout()
+
+    for row, (bounds, search) in enumerate(configs):
+        for col, dataset in enumerate(datasets):
+            ax = axs[row,col]
+            data = df[
+                    (df['dataset']==dataset) &
+                    (df['layer1']==l1) &
+                    (df['layer2']==l2) &
+                    (df['bounds']==bounds) &
+                    (df['search']==search)
+            ]
+            for key_type in key_types:
+                d = data[data['key_type']==key_type]
+                ax.plot(d['n_models'], d['lookup_time_per_key'], marker='.', label=key_type)
+
+            # Title
+            ax.set_title(f'{dataset} ({bounds}, {search})')
+
+            # Labels
+            if row==n_rows-1:
+                ax.set_xlabel('Number of segments')
+            if col==0:
+                ax.set_ylabel('Lookup time [ns]')
+
+            # Visuals
+            ax.set_xscale('log', base=2)
+            ax.set_ylim(bottom=0)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(key_types), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_key_types.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of times
+    df = df.groupby(['dataset','key_type','layer1','layer2','n_models','bounds','search']).median().reset_index()
+
+    # Replace datasets and model names
+    dataset_dict = {
+        "books_200M_uint64": "books",
+        "fb_200M_uint64": "fb",
+        "osm_cellids_200M_uint64": "osmc",
+        "wiki_ts_200M_uint64": "wiki"
+    }
+    model_dict = {
+        "centered_linear_regression": "CLR",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    df.replace({**dataset_dict, **model_dict}, inplace=True)
+
+    # Compute metrics
+    df['lookup_time_per_key'] = df['lookup_time'] / df['n_samples']
+    df.sort_values('n_models', inplace=True)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+    key_types = ['uint32', 'uint64', 'int64', 'double', 'uint128']
+    configs = [('none', 'model_biased_exponential'), ('labs', 'binary'), ('labs', 'cacheline_binary'),
+               ('lind', 'model_biased_binary')]
+    l1models = sorted(df['layer1'].unique())
+    l2models = sorted(df['layer2'].unique())
+
+    # Plot lookup time by key type
+    for l1 in l1models:
+        for l2 in l2models:
+            filename = f'rmi_key_types-{l1}-{l2}.pdf'
+            print(f'Plotting lookup time by key type to \'{filename}\'...')
+            plot_key_types(l1, l2, filename)
@@ -19,10 +19,10 @@ args = vars(parser.parse_args())
 
 
 def plot_full(filename='rmi_lookup-full.pdf'):
-    n_rows = len(datasets)
-    n_cols = len(l1models) * len(l2models)
+    configs = sorted(set(zip(df['layer1'], df['layer2'])))
 
-    configs = itertools.product(l1models, l2models)
+    n_rows = len(datasets)
+    n_cols = len(configs)
 
     fig, axs = plt.subplots(n_rows, n_cols, figsize=(5*n_cols, 4.2*n_rows), sharey=True, sharex=True)
     fig.tight_layout()
@@ -57,7 +57,7 @@ def plot_full(filename='rmi_lookup-full.pdf'):
 
             # Legend
             if row==0 and col==0:
-                fig.legend(ncol=len(corr_configs), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+                fig.legend(ncol=len(corr_configs) + len(layout_configs), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
 
     fig.savefig(os.path.join(path, filename), bbox_inches='tight')
 
@@ -167,6 +167,52 @@ def plot_correction(filename='rmi_lookup-error_correction.pdf'):
     fig.savefig(os.path.join(path, filename), bbox_inches='tight')
 
 
+def plot_fixed_point(filename='rmi_lookup-fixed_point.pdf', search='Bin'):
+    models = [('LS','LR'),('FLS','FLR')]
+    bounds = ['LAbs','LInd']
+    metrics = [('predict_in_ns', 'Model eval time [ns]'), ('lookup_in_ns', 'Lookup time [ns]')]
+
+    n_rows = len(datasets)
+    n_cols = len(metrics)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharex=True, squeeze=False)
+    fig.tight_layout()
+
+    for row, dataset in enumerate(datasets):
+        for col, (metric, label) in enumerate(metrics):
+            ax = axs[row,col]
+            for l1, l2 in models:
+                for bound in bounds:
+                    data = df[
+                            (df['dataset']==dataset) &
+                            (df['layer1']==l1) &
+                            (df['layer2']==l2) &
+                            (df['bounds']==bound) &
+                            (df['search']==search)
+                    ]
+                    if not data.empty:
+                        ax.plot(data['size_in_MiB'], data[metric], label=f'{l1}$\mapsto${l2} {bound}',
+                                c=corr_colors[(bound,search)], ls='--' if l1.startswith('F') else '-')
+
+            # Title
+            ax.set_title(dataset)
+
+            # Labels
+            if row==n_rows-1:
+                ax.set_xlabel('Index size [MiB]')
+            ax.set_ylabel(label)
+
+            # Visuals
+            ax.set_ylim(bottom=0)
+            ax.set_xscale('log')
+
+            # Legend
+            if row==0 and col==0:
+                fig.legend(ncol=len(models) * len(bounds), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
 if __name__ == "__main__":
     path = 'results'
 
@@ -188,14 +234,20 @@ if __name__ == "__main__":
         "cubic_spline": "CS",
         "linear_spline": "LS",
         "linear_regression": "LR",
-        "radix": "RX"
+        "radix": "RX",
+        "fixed_linear_spline": "FLS",
+        "fixed_linear_regression": "FLR"
     }
     bounds_dict = {
         "labs": "LAbs",
         "lind": "LInd",
         "gabs": "GAbs",
         "gind": "GInd",
-        "none": "NB"
+        "none": "NB",
+        "labs_interleaved": "LAbs-IL",
+        "lind_interleaved": "LInd-IL",
+        "labs_huge": "LAbs-HP",
+        "lind_huge": "LInd-HP"
     }
     search_dict = {
         "binary": "Bin",
@@ -208,6 +260,7 @@ if __name__ == "__main__":
     # Compute metrics
     df['size_in_MiB'] = df['size_in_bytes'] / (1024 * 1024)
     df['lookup_in_ns'] = df['lookup_time'] / df['n_samples']
+    df['predict_in_ns'] = df['predict_time'] / df['n_samples']
 
     # Define variable lists
     datasets = sorted(df['dataset'].unique())
@@ -222,6 +275,12 @@ if __name__ == "__main__":
         ('LInd','Bin'),('LInd','MBin'),
         ('NB','MExp'),('NB','MLin'),
     ]
+    layout_configs = [
+        ('LAbs-IL','Bin'),
+        ('LInd-IL','Bin'),('LInd-IL','MBin'),
+        ('LAbs-HP','Bin'),
+        ('LInd-HP','Bin'),('LInd-HP','MBin'),
+    ]
 
     # Set colors
     model_colors = {}
@@ -234,6 +293,10 @@ if __name__ == "__main__":
     n_colors = len(corr_configs)
     for i, (bound, search) in enumerate(corr_configs):
         corr_colors[(bound,search)] = cmap(i/n_colors)
+    cmap = cm.get_cmap('Set1')
+    n_colors = 9
+    for i, (bound, search) in enumerate(layout_configs):
+        corr_colors[(bound,search)] = cmap(i/n_colors)
 
     if args['paper']:
         # Plot model types
@@ -250,3 +313,8 @@ if __name__ == "__main__":
         filename = 'rmi_lookup-full.pdf'
         print(f'Plotting full lookup time results to \'{filename}\'...')
         plot_full(filename)
+
+        # Plot fixed-point models
+        filename = 'rmi_lookup-fixed_point.pdf'
+        print(f'Plotting model eval and lookup time of fixed-point models to \'{filename}\'...')
+        plot_fixed_point(filename)
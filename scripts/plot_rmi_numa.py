@@ -0,0 +1,128 @@
+#!python3
+import argparse
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_numa(l1, n_models, filename='rmi_numa.pdf'):
+    n_rows = len(datasets)
+    n_cols = len(corr_configs)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharey='row', sharex=True, squeeze=False)
+    fig.tight_layout()
+
+    for row, dataset in enumerate(datasets):
+        for col, (bound, search) in enumerate(corr_configs):
+            ax = axs[row,col]
+            for replication in replications:
+                data = df[
+                        (df['dataset']==dataset) &
+                        (df['layer1']==l1) &
+                        (df['n_models']==n_models) &
+                        (df['bounds']==bound) &
+                        (df['search']==search) &
+                        (df['replication']==replication)
+                ]
+                ax.plot(data['n_threads'], data['mlookups_per_s'], marker='.', label=replication_dict[replication],
+                        color=replication_colors[replication])
+
+            # Title
+            ax.set_title(f'{dataset} ({l1}, $2^{{{n_models.bit_length() - 1}}}$ models, {bound}+{search})')
+
+            # Labels
+            if row==n_rows-1:
+                ax.set_xlabel('Number of threads')
+            if col==0:
+                ax.set_ylabel('Throughput [Mlookups/s]')
+
+            # Visuals
+            ax.set_ylim(bottom=0)
+            ax.set_xscale('log', base=2)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(labels), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_numa.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of lookup times
+    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','n_threads','replication']).median().reset_index()
+
+    # Replace datasets, model names, bounds, and searches
+    dataset_dict = {
+        "books_200M_uint64": "books",
+        "fb_200M_uint64": "fb",
+        "osm_cellids_200M_uint64": "osmc",
+        "wiki_ts_200M_uint64": "wiki"
+    }
+    model_dict = {
+        "cubic_spline": "CS",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    bounds_dict = {
+        "labs": "LAbs",
+        "lind": "LInd",
+        "gabs": "GAbs",
+        "gind": "GInd",
+        "none": "NB"
+    }
+    search_dict = {
+        "binary": "Bin",
+        "model_biased_binary": "MBin",
+        "model_biased_exponential": "MExp",
+    }
+    df['bounds'] = df['bounds'].replace(bounds_dict)
+    df.replace({**dataset_dict, **model_dict, **search_dict}, inplace=True)
+    replication_dict = {
+        "none": "single copy",
+        "index": "replicated index",
+        "index_keys": "replicated index and keys"
+    }
+
+    # Compute metrics
+    df['mlookups_per_s'] = df['n_samples'] / df['lookup_time'] * 1000
+    df.sort_values('n_threads', inplace=True)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+    l1models = sorted(df['layer1'].unique())
+    n_models_list = sorted(df['n_models'].unique())
+    replications = [r for r in replication_dict.keys() if r in df['replication'].unique()]
+    corr_configs = [(bound, search) for bound, search in [('NB','MExp'),('LAbs','Bin'),('LInd','MBin')]
+                    if not df[(df['bounds']==bound) & (df['search']==search)].empty]
+
+    # Set colors
+    replication_colors = {
+        "none": "tab:blue",
+        "index": "tab:orange",
+        "index_keys": "tab:green"
+    }
+
+    # Plot throughput by number of threads
+    for l1 in l1models:
+        for n_models in n_models_list:
+            filename = f'rmi_numa-{l1}-{n_models}.pdf'
+            print(f'Plotting throughput by number of threads to \'{filename}\'...')
+            plot_numa(l1, int(n_models), filename)
@@ -0,0 +1,129 @@
+#!python3
+import argparse
+import matplotlib.cm as cm
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_range(l1, n_models, filename='rmi_range.pdf'):
+    n_rows = len(datasets)
+    n_cols = len(corr_configs)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharey='row', sharex=True, squeeze=False)
+    fig.tight_layout()
+
+    for row, dataset in enumerate(datasets):
+        for col, (bound, search) in enumerate(corr_configs):
+            ax = axs[row,col]
+            data = df[
+                    (df['dataset']==dataset) &
+                    (df['layer1']==l1) &
+                    (df['n_models']==n_models) &
+                    (df['bounds']==bound) &
+                    (df['search']==search)
+            ]
+            for api in apis:
+                d = data[(data['api']==api) & (data['workload']=='selectivity')]
+                ax.plot(d['selectivity'], d['lookup_time_per_range'], marker='.', label=api_dict[api],
+                        color=api_colors[api])
+                d = data[(data['api']==api) & (data['workload']=='uniform')]
+                ax.axhline(d['lookup_time_per_range'].median(), linestyle=':', label=f'{api_dict[api]} (uniform)',
+                        color=api_colors[api])
+
+            # Title
+            ax.set_title(f'{dataset} ({l1}, $2^{{{n_models.bit_length() - 1}}}$ models, {bound}+{search})')
+
+            # Labels
+            if row==n_rows-1:
+                ax.set_xlabel('Selectivity')
+            if col==0:
+                ax.set_ylabel('Lookup time [ns]')
+
+            # Visuals
+            ax.set_ylim(bottom=0)
+            ax.set_xscale('log')
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=len(labels), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_range.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of lookup times
+    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','workload','selectivity','api']).median().reset_index()
+
+    # Replace datasets and model names
+    dataset_dict = {
+        "books_200M_uint64": "books",
+        "fb_200M_uint64": "fb",
+        "osm_cellids_200M_uint64": "osmc",
+        "wiki_ts_200M_uint64": "wiki"
+    }
+    model_dict = {
+        "cubic_spline": "CS",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    search_dict = {
+        "binary": "Bin",
+        "model_biased_binary": "MBin",
+        "model_biased_exponential": "MExp",
+    }
+    bound_dict = {
+        "none": "NB",
+        "labs": "LAbs",
+        "lind": "LInd",
+        "gabs": "GAbs",
+        "gind": "GInd",
+    }
+    api_dict = {
+        "independent": "independent endpoints",
+        "shared": "shared window",
+    }
+    df.replace({**dataset_dict, **model_dict, **search_dict, **bound_dict}, inplace=True)
+
+    # Compute metrics
+    df['lookup_time_per_range'] = df['lookup_time'] / df['n_samples']
+    df.sort_values('selectivity', inplace=True)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+    l1models = sorted(df['layer1'].unique())
+    n_models_list = sorted(df['n_models'].unique())
+    corr_configs = sorted(df[['bounds','search']].drop_duplicates().itertuples(index=False, name=None))
+    apis = [api for api in api_dict if api in df['api'].unique()]
+
+    # Set colors
+    api_colors = {}
+    cmap = cm.get_cmap('tab10')
+    n_colors = 10
+    for i, api in enumerate(apis):
+        api_colors[api] = cmap(i/n_colors)
+
+    # Plot lookup time by selectivity
+    for l1 in l1models:
+        for n_models in n_models_list:
+            filename = f'rmi_range-{l1}-{n_models}.pdf'
+            print(f'Plotting lookup time by selectivity to \'{filename}\'...')
+            plot_range(l1, int(n_models), filename)
@@ -0,0 +1,110 @@
+#!python3
+import argparse
+import matplotlib.cm as cm
+import matplotlib.pyplot as plt
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_update(l1, n_models, filename='rmi_update.pdf'):
+    n_cols = len(datasets)
+
+    fig, axs = plt.subplots(1, n_cols, figsize=(4*n_cols, 2.7), sharey=True, squeeze=False)
+    fig.tight_layout()
+
+    for col, dataset in enumerate(datasets):
+        ax = axs[0,col]
+        data = df[
+                (df['dataset']==dataset) &
+                (df['layer1']==l1) &
+                (df['n_models']==n_models)
+        ]
+        for threshold in thresholds:
+            d = data[data['delta_threshold']==threshold]
+            ax.plot(d['write_ratio'], d['mixed_mops'], marker='.', label=f'mixed (threshold {threshold})',
+                    color=threshold_colors[threshold])
+            ax.plot(d['write_ratio'], d['read_mops'], marker='.', linestyle='--',
+                    label=f'read after updates (threshold {threshold})', color=threshold_colors[threshold])
+        d = data.groupby('write_ratio').median().reset_index()
+        ax.plot(d['write_ratio'], d['static_read_mops'], marker='', linestyle=':', label='read static', color='black')
+
+        # Title
+        ax.set_title(f'{dataset} ({l1}, $2^{{{n_models.bit_length() - 1}}}$ models)')
+
+        # Labels
+        ax.set_xlabel('Write ratio')
+        if col==0:
+            ax.set_ylabel('Throughput [Mops/s]')
+
+        # Visuals
+        ax.set_ylim(bottom=0)
+        ax.set_xscale('symlog', linthresh=0.01)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=4, bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'rmi_update.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+
+    # Compute median of times
+    df = df.groupby(['dataset','layer1','layer2','n_models','delta_threshold','write_ratio']).median().reset_index()
+
+    # Replace datasets and model names
+    dataset_dict = {
+        "books_200M_uint64": "books",
+        "fb_200M_uint64": "fb",
+        "osm_cellids_200M_uint64": "osmc",
+        "wiki_ts_200M_uint64": "wiki"
+    }
+    model_dict = {
+        "cubic_spline": "CS",
+        "linear_spline": "LS",
+        "linear_regression": "LR",
+        "radix": "RX"
+    }
+    df.replace({**dataset_dict, **model_dict}, inplace=True)
+
+    # Compute metrics
+    df['mixed_mops'] = df['n_ops'] / df['mixed_time'] * 1000
+    df['read_mops'] = df['n_ops'] / df['read_time'] * 1000
+    df['static_read_mops'] = df['n_ops'] / df['static_read_time'] * 1000
+    df.sort_values('write_ratio', inplace=True)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+    l1models = sorted(df['layer1'].unique())
+    n_models_list = sorted(df['n_models'].unique())
+    thresholds = sorted(df['delta_threshold'].unique())
+
+    # Set colors
+    threshold_colors = {}
+    cmap = cm.get_cmap('tab10')
+    n_colors = 10
+    for i, threshold in enumerate(thresholds):
+        threshold_colors[threshold] = cmap(i/n_colors)
+
+    # Plot throughput by write ratio
+    for l1 in l1models:
+        for n_models in n_models_list:
+            filename = f'rmi_update-{l1}-{n_models}.pdf'
+            print(f'Plotting throughput by write ratio to \'{filename}\'...')
+            plot_update(l1, int(n_models), filename)
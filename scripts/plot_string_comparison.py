@@ -0,0 +1,113 @@
+#!python3
+import argparse
+import matplotlib.cm as cm
+import matplotlib.pyplot as plt
+import numpy as np
+import os
+import pandas as pd
+import warnings
+
+plt.style.use(os.path.join('scripts', 'matplotlibrc'))
+
+# Ignore warnings
+warnings.filterwarnings( "ignore")
+
+# Argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('-p', '--paper', help='produce paper plots', action='store_true')
+args = vars(parser.parse_args())
+
+
+def plot_metric(metric, ylabel, filename, width_fact=5, height_fact=4.2):
+    n_cols = len(datasets)
+
+    fig, axs = plt.subplots(1, n_cols, figsize=(width_fact*n_cols, height_fact), sharey=True, squeeze=False)
+    fig.tight_layout()
+
+    for col, dataset in enumerate(datasets):
+        ax = axs[0,col]
+
+        # Plot indexes
+        for index in index_dict.keys():
+            data = df[
+                (df['dataset']==dataset) &
+                (df['index']==index)
+            ]
+            if index=='RMI-ours':
+                for config in sorted(data['rmi_type'].unique()):
+                    d = data[data['rmi_type']==config].sort_values('size_in_MiB')
+                    ax.plot(d['size_in_MiB'], d[metric], color=colors[config], label=f'{index_dict[index]} {config}',
+                            alpha=0.9)
+            elif not data.empty:
+                data = data.sort_values('size_in_MiB')
+                ax.plot(data['size_in_MiB'], data[metric], color=colors[index], label=index_dict[index], alpha=0.9)
+
+        # Binary search
+        data = df[
+            (df['dataset']==dataset) &
+            (df['index']=='Binary search')
+        ]
+        if metric=='lookup_in_ns' and not data.empty:
+            ax.axhline(y=data.iloc[0][metric], marker='None', color='.2', dashes=(2, 1), label='Binary search')
+
+        # Title
+        ax.set_title(dataset)
+
+        # Labels
+        ax.set_xlabel('Index size [MiB]')
+        if col==0:
+            ax.set_ylabel(ylabel)
+
+        # Visuals
+        ax.set_xscale('log')
+        ax.set_ylim(bottom=0)
+
+    # Legend
+    handles, labels = axs[0,0].get_legend_handles_labels()
+    fig.legend(handles, labels, ncol=4, bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
+if __name__ == "__main__":
+    path = 'results'
+
+    # Read csv file
+    file = os.path.join(path, 'string_comparison.csv')
+    df = pd.read_csv(file, delimiter=',', header=0, comment='#')
+    df = df.replace({np.nan: '-'})
+
+    # Compute medians
+    df = df.groupby(['dataset', 'index', 'config']).median().reset_index()
+
+    index_dict = {
+        'RMI-ours': 'RMI',
+        'B-tree': 'B-tree',
+        'ART': 'ART'
+    }
+
+    # Compute metrics
+    df['size_in_MiB'] = df['size_in_bytes'] / (1024 * 1024)
+    df['build_in_s'] = df['build_time'] / 1000000000
+    df['lookup_in_ns'] = df['lookup_time'] / df['n_samples']
+    df['rmi_type'] = df['config'].str.extract(r'rmi::(\w+),', expand=False)
+
+    # Define variable lists
+    datasets = sorted(df['dataset'].unique())
+
+    # Set colors
+    cmap = cm.get_cmap('tab10')
+    n_colors = 10
+    colors = {}
+    for i, key in enumerate(['Rmi', 'RmiLAbs', 'RmiLInd', 'B-tree', 'ART']):
+        colors[key] = cmap(i/n_colors)
+
+    # Plot lookup times against index size
+    filename = 'string_comparison-lookup_time.pdf'
+    print(f'Plotting lookup time results to \'{filename}\'...')
+    plot_metric('lookup_in_ns', 'Lookup time [ns]', filename)
+
+    # Plot build times against index size
+    filename = 'string_comparison-build_time.pdf'
+    print(f'Plotting build time results to \'{filename}\'...')
+    plot_metric('build_in_s', 'Build time [s]', filename)
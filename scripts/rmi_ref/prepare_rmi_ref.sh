@@ -8,6 +8,10 @@ CONFIG_PATH="scripts/rmi_ref"
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
 
+# Set GENERATOR=native to generate the RMIs with build/bin/rmi_codegen instead of the Rust reference implementation.
+GENERATOR="${GENERATOR:-rust}"
+BIN_CODEGEN="build/bin/rmi_codegen"
+
 gen_config_json() {
     DATASET=$1
     CWD=$(pwd)
@@ -37,11 +41,45 @@ train_rmi () {
     cd ${CWD}
 }
 
+# Emits "namespace layer1 layer2 n_models" per configuration, mapping the layers of the reference implementation to
+# the closest models of this repository.
+list_configs() {
+    python3 - "$1" <<'EOF_PY'
+import json, sys
+models = {'linear_spline': 'linear_spline', 'linear': 'linear_regression', 'robust_linear': 'linear_regression',
+          'cubic': 'cubic_spline'}
+for config in json.load(open(sys.argv[1]))['configs']:
+    layers = [l if not l.startswith('radix') else 'radix' for l in config['layers'].split(',')]
+    layers = [models.get(l, l) for l in layers]
+    print(config['namespace'], layers[0], layers[1], config['branching factor'])
+EOF_PY
+}
+
+generate_rmi () {
+    DATASET=$1
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    CONFIG_FILE="${CONFIG_PATH}/${DATASET}.json"
+
+    # Create include dir
+    INCLUDE_PATH="${RMI_PATH}/include/rmi_ref"
+    mkdir -p "${INCLUDE_PATH}"
+
+    echo "Generating specialized RMIs on ${DATASET}..."
+    list_configs "${CONFIG_FILE}" | while read NAMESPACE L1 L2 N_MODELS; do
+        ${BIN_CODEGEN} "${DATA_FILE}" ${L1} ${L2} ${N_MODELS} labs ${NAMESPACE} --output "${INCLUDE_PATH}"
+    done
+}
+
 for dataset in ${DATASETS};
 do
     # Generate RMI configurations
     # gen_config_json "$dataset" # configs are pre-generated
 
-    # Train RMIs
-    train_rmi "$dataset"
+    if [ "${GENERATOR}" == "native" ]; then
+        # Generate specialized RMIs of this repository
+        generate_rmi "$dataset"
+    else
+        # Train RMIs
+        train_rmi "$dataset"
+    fi
 done
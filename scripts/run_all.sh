@@ -17,8 +17,35 @@ source scripts/run_rmi_lookup.sh
 echo "Running RMI Build (Section 7)..."
 source scripts/run_rmi_build.sh
 
+echo "Running RMI Calibrate..."
+source scripts/run_rmi_calibrate.sh
+
 echo "Running RMI Guideline (Section 8)..."
 source scripts/run_rmi_guideline.sh
 
+echo "Running RMI Depth..."
+source scripts/run_rmi_depth.sh
+
+echo "Running RMI Update..."
+source scripts/run_rmi_update.sh
+
+echo "Running RMI NUMA..."
+source scripts/run_rmi_numa.sh
+
+echo "Running RMI Key Types..."
+source scripts/run_rmi_key_types.sh
+
+echo "Running String Comparison..."
+source scripts/run_string_comparison.sh
+
+echo "Running RMI Map..."
+source scripts/run_rmi_map.sh
+
+echo "Running RMI Range..."
+source scripts/run_rmi_range.sh
+
+echo "Running RMI Duplicates..."
+source scripts/run_rmi_duplicates.sh
+
 echo "Running Index Comparison (Section 9)..."
 source scripts/run_index_comparison.sh
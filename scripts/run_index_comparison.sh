@@ -15,6 +15,13 @@ N_REPS="3"
 N_SAMPLES="20000000"
 PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
 
+# Use machine profile written by rmi_calibrate if available
+FILE_PROFILE="${DIR_RESULTS}/machine_profile.csv"
+if [ -f "${FILE_PROFILE}" ];
+then
+    PARAMS="${PARAMS} --profile ${FILE_PROFILE}"
+fi
+
 # Set which indexes to run on datasets
 declare -A flags
 flags['books_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --bin"
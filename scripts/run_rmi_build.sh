@@ -19,6 +19,8 @@ DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_
 LAYER1="cubic_spline linear_spline linear_regression radix"
 LAYER2="linear_spline linear_regression"
 BOUNDS="none gabs gind labs lind"
+THREADS="1 2 4 8 16 32"
+SAMPLE_RATES="1 0.1 0.01 0.001 0.0001"
 
 run() {
     DATASET=$1
@@ -26,8 +28,11 @@ run() {
     L2=$3
     N_MODELS=$4
     BOUND=$5
+    N_THREADS=${6:-1}
+    SAMPLE_RATE=${7:-1}
+    STREAM=${8:-}
     DATA_FILE="${DIR_DATA}/${DATASET}"
-    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${PARAMS} >> ${FILE_RESULTS}
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${PARAMS} --n_threads ${N_THREADS} --sample_rate ${SAMPLE_RATE} ${STREAM} >> ${FILE_RESULTS}
 }
 
 # Create results directory
@@ -44,7 +49,7 @@ then
 fi
 
 # Write csv header
-echo "dataset,n_keys,rmi,layer1,layer2,n_models,bounds,size_in_bytes,rep,build_time,checksum" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,rmi,layer1,layer2,n_models,bounds,size_in_bytes,rep,n_threads,sample_rate,build_time,load_time,data_load_time,mean_log2_error,checksum" > ${FILE_RESULTS} # Write csv header
 
 # Run layer1 and layer 2 model type experiment
 for dataset in ${DATASETS};
@@ -66,6 +71,45 @@ do
     done
 done
 
+# Run multi-threaded build experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} (threads) on '${dataset}'..."
+    for n_threads in ${THREADS};
+    do
+        for bound in ${BOUNDS};
+        do
+            run ${dataset} linear_spline linear_regression $((2**20)) ${bound} ${n_threads}
+        done
+    done
+done
+
+# Run sampled build experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} (sampling) on '${dataset}'..."
+    for sample_rate in ${SAMPLE_RATES};
+    do
+        for bound in ${BOUNDS};
+        do
+            run ${dataset} linear_spline linear_regression $((2**20)) ${bound} 1 ${sample_rate}
+        done
+    done
+done
+
+# Run streaming build experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} (streaming) on '${dataset}'..."
+    for sample_rate in ${SAMPLE_RATES};
+    do
+        for bound in ${BOUNDS};
+        do
+            run ${dataset} linear_spline linear_regression $((2**20)) ${bound} 1 ${sample_rate} --stream
+        done
+    done
+done
+
 
 # Prepare reference implementation experiment
 CWD=$(pwd)
@@ -115,7 +159,7 @@ do
                         build_time=$(cat ${TMP_PATH}/tmp.h | grep BUILD | sed 's/.*=//' | tr -d -c 0-9)
 
                         # Append results to csv.
-                        echo "${dataset},200000000,ref,${l1},${l2},${n_models},${bound},${size},${rep},${build_time},0" >> ${RESULTS_FILE}
+                        echo "${dataset},200000000,ref,${l1},${l2},${n_models},${bound},${size},${rep},1,1,${build_time},0,,,0" >> ${RESULTS_FILE}
                     done
                 done
             done
@@ -0,0 +1,25 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi calibrate"
+
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/machine_profile.csv"
+
+BIN="build/bin/rmi_calibrate"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="100000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Run calibration
+echo "Performing ${EXPERIMENT}..."
+${BIN} ${PARAMS} --output ${FILE_RESULTS}
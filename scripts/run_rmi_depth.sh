@@ -0,0 +1,87 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi depth"
+
+DIR_DATA="data"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_depth.csv"
+
+BIN="build/bin/rmi_depth"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="20000000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+TIMEOUT="300s"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+LAYER1="linear_spline cubic_spline radix"
+LAYER2="linear_regression"
+
+run() {
+    DATASET=$1
+    L1=$2
+    L2=$3
+    LAYER_SIZES=$4
+    BOUND=$5
+    SEARCH=$6
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${LAYER_SIZES} ${BOUND} ${SEARCH} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check data downloaded
+if [ ! -d "${DIR_DATA}" ];
+then
+    >&2 echo "Please download datasets first."
+    return 1
+fi
+
+# Write csv header
+echo "dataset,n_keys,layer1,layer2,n_layers,layer_sizes,n_models,bounds,search,size_in_bytes,rep,n_samples,build_time,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+
+# Run depth experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} on '${dataset}'..."
+    for l1 in ${LAYER1};
+    do
+        for l2 in ${LAYER2};
+        do
+            for ((i=10; i<=25; i += 1));
+            do
+                n_models=$((2**$i))
+
+                # Two layers
+                run ${dataset} ${l1} ${l2} ${n_models} none model_biased_exponential
+                run ${dataset} ${l1} ${l2} ${n_models} labs binary
+                run ${dataset} ${l1} ${l2} ${n_models} lind model_biased_binary
+
+                # Three layers with a cache-resident second layer
+                for ((j=8; j<=16 && j<i; j += 4));
+                do
+                    layer_sizes="$((2**$j)),${n_models}"
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} none model_biased_exponential
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} labs binary
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} lind model_biased_binary
+                done
+
+                # Four layers
+                if [ ${i} -gt 16 ];
+                then
+                    layer_sizes="$((2**8)),$((2**16)),${n_models}"
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} none model_biased_exponential
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} labs binary
+                    run ${dataset} ${l1} ${l2} ${layer_sizes} lind model_biased_binary
+                fi
+            done
+        done
+    done
+done
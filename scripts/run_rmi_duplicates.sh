@@ -0,0 +1,61 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi duplicates"
+
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_duplicates.csv"
+
+BIN="build/bin/rmi_duplicates"
+
+# Set number of keys, repetitions, and samples
+N_KEYS="200000000"
+N_REPS="3"
+N_SAMPLES="20000000"
+PARAMS="--n_keys ${N_KEYS} --n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+TIMEOUT="600s"
+
+RUN_LENGTHS="1 2 4 16 64 256 1024"
+LAYER1="linear_spline cubic_spline radix"
+LAYER2="linear_regression"
+
+run() {
+    RUN_LENGTH=$1
+    L1=$2
+    L2=$3
+    N_MODELS=$4
+    BOUND=$5
+    SEARCH=$6
+    timeout ${TIMEOUT} ${BIN} synthetic ${L1} ${L2} ${N_MODELS} ${BOUND} ${SEARCH} -r ${RUN_LENGTH} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Write csv header
+echo "dataset,n_keys,n_distinct,layer1,layer2,n_models,bounds,search,size_in_bytes,build_time,mean_interval,api,op,rep,n_samples,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+
+# Run duplicates experiment
+for run_length in ${RUN_LENGTHS};
+do
+    echo "Performing ${EXPERIMENT} with mean run length ${run_length}..."
+    for l1 in ${LAYER1};
+    do
+        for l2 in ${LAYER2};
+        do
+            for ((i=16; i<=24; i += 4));
+            do
+                n_models=$((2**$i))
+                run ${run_length} ${l1} ${l2} ${n_models} none model_biased_exponential
+                run ${run_length} ${l1} ${l2} ${n_models} labs binary
+                run ${run_length} ${l1} ${l2} ${n_models} lind model_biased_binary
+                run ${run_length} ${l1} ${l2} ${n_models} gabs binary
+                run ${run_length} ${l1} ${l2} ${n_models} gind model_biased_binary
+            done
+        done
+    done
+done
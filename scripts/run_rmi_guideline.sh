@@ -15,6 +15,13 @@ N_REPS="3"
 N_SAMPLES="20000000"
 PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
 
+# Use machine profile written by rmi_calibrate if available
+FILE_PROFILE="${DIR_RESULTS}/machine_profile.csv"
+if [ -f "${FILE_PROFILE}" ];
+then
+    PARAMS="${PARAMS} --profile ${FILE_PROFILE}"
+fi
+
 run() {
     DATASET=$1
     BUDGET=$2
@@ -38,7 +45,7 @@ fi
 DATASETS="books_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
 
 # Run experiments
-echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,budget_in_bytes,is_guideline,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,budget_in_bytes,is_guideline,is_tuned,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
 for dataset in ${DATASETS};
 do
     echo "Performing ${EXPERIMENT} on '${dataset}'..."
@@ -0,0 +1,73 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi key types"
+
+DIR_DATA="data"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_key_types.csv"
+
+BIN="build/bin/rmi_key_types"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="10000000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+TIMEOUT="300s"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+KEY_TYPES="uint32 uint64 int64 double uint128"
+LAYER1="linear_spline radix"
+LAYER2="linear_regression centered_linear_regression"
+
+run() {
+    DATASET=$1
+    KEY_TYPE=$2
+    L1=$3
+    L2=$4
+    N_MODELS=$5
+    BOUND=$6
+    SEARCH=$7
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${KEY_TYPE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${SEARCH} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check data downloaded
+if [ ! -d "${DIR_DATA}" ];
+then
+    >&2 echo "Please download datasets first."
+    return 1
+fi
+
+# Write csv header
+echo "dataset,n_keys,key_type,key_size,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,build_time,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+
+# Run key type experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} on '${dataset}'..."
+    for key_type in ${KEY_TYPES};
+    do
+        for l1 in ${LAYER1};
+        do
+            for l2 in ${LAYER2};
+            do
+                for ((i=12; i<=24; i += 4));
+                do
+                    n_models=$((2**$i))
+                    run ${dataset} ${key_type} ${l1} ${l2} ${n_models} none model_biased_exponential
+                    run ${dataset} ${key_type} ${l1} ${l2} ${n_models} labs binary
+                    run ${dataset} ${key_type} ${l1} ${l2} ${n_models} labs cacheline_binary
+                    run ${dataset} ${key_type} ${l1} ${l2} ${n_models} lind model_biased_binary
+                done
+            done
+        done
+    done
+done
@@ -45,7 +45,7 @@ then
 fi
 
 # Write csv header
-echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,lookup_time,predict_time,search_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,lookup_time,lookup_accu,predict_time,search_time,batch_lookup_time,batch_lookup_accu,n_inflight,coro_lookup_time,coro_lookup_accu,data_load_time" > ${FILE_RESULTS} # Write csv header
 
 # Run model type experiment
 for dataset in ${DATASETS};
@@ -70,7 +70,29 @@ do
 
                 run ${dataset} ${l1} ${l2} ${n_models} lind model_biased_binary
                 run ${dataset} ${l1} ${l2} ${n_models} lind binary
+
+                run ${dataset} ${l1} ${l2} ${n_models} labs_interleaved binary
+
+                run ${dataset} ${l1} ${l2} ${n_models} lind_interleaved model_biased_binary
+                run ${dataset} ${l1} ${l2} ${n_models} lind_interleaved binary
+
+                run ${dataset} ${l1} ${l2} ${n_models} labs_huge binary
+
+                run ${dataset} ${l1} ${l2} ${n_models} lind_huge model_biased_binary
+                run ${dataset} ${l1} ${l2} ${n_models} lind_huge binary
             done
         done
     done
 done
+
+# Run fixed-point model experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} with fixed-point models on '${dataset}'..."
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        run ${dataset} fixed_linear_spline fixed_linear_regression ${n_models} labs binary
+        run ${dataset} fixed_linear_spline fixed_linear_regression ${n_models} lind binary
+    done
+done
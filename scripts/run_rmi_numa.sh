@@ -0,0 +1,72 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi numa"
+
+DIR_DATA="data"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_numa.csv"
+
+BIN="build/bin/rmi_numa"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="100000000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+TIMEOUT="600s"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+LAYER1="linear_spline cubic_spline radix"
+LAYER2="linear_regression"
+THREADS="1 2 4 8 16 32 64"
+
+run() {
+    DATASET=$1
+    L1=$2
+    L2=$3
+    N_MODELS=$4
+    BOUND=$5
+    SEARCH=$6
+    N_THREADS=$7
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${SEARCH} -t ${N_THREADS} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check data downloaded
+if [ ! -d "${DIR_DATA}" ];
+then
+    >&2 echo "Please download datasets first."
+    return 1
+fi
+
+# Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,n_nodes,n_threads,replication,rep,n_samples,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+
+# Run numa experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} on '${dataset}'..."
+    for l1 in ${LAYER1};
+    do
+        for l2 in ${LAYER2};
+        do
+            for ((i=16; i<=24; i += 4));
+            do
+                n_models=$((2**$i))
+                for n_threads in ${THREADS};
+                do
+                    run ${dataset} ${l1} ${l2} ${n_models} none model_biased_exponential ${n_threads}
+                    run ${dataset} ${l1} ${l2} ${n_models} labs binary ${n_threads}
+                    run ${dataset} ${l1} ${l2} ${n_models} lind model_biased_binary ${n_threads}
+                done
+            done
+        done
+    done
+done
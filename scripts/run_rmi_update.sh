@@ -0,0 +1,73 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi update"
+
+DIR_DATA="data"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_update.csv"
+
+BIN="build/bin/rmi_update"
+
+# Set number of repetitions and operations
+N_REPS="3"
+N_OPS="10000000"
+PARAMS="--n_reps ${N_REPS} --n_ops ${N_OPS}"
+TIMEOUT="600s"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+LAYER1="linear_spline cubic_spline radix"
+LAYER2="linear_regression"
+WRITE_RATIOS="0 0.01 0.1 0.5 0.9"
+DELTA_THRESHOLDS="64 256 1024"
+
+run() {
+    DATASET=$1
+    L1=$2
+    L2=$3
+    N_MODELS=$4
+    THRESHOLD=$5
+    RATIO=$6
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} -d ${THRESHOLD} -w ${RATIO} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check data downloaded
+if [ ! -d "${DIR_DATA}" ];
+then
+    >&2 echo "Please download datasets first."
+    return 1
+fi
+
+# Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,delta_threshold,write_ratio,rep,n_ops,mixed_time,read_time,static_read_time,checksum" > ${FILE_RESULTS} # Write csv header
+
+# Run update experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} on '${dataset}'..."
+    for l1 in ${LAYER1};
+    do
+        for l2 in ${LAYER2};
+        do
+            for ((i=16; i<=24; i += 4));
+            do
+                n_models=$((2**$i))
+                for threshold in ${DELTA_THRESHOLDS};
+                do
+                    for ratio in ${WRITE_RATIOS};
+                    do
+                        run ${dataset} ${l1} ${l2} ${n_models} ${threshold} ${ratio}
+                    done
+                done
+            done
+        done
+    done
+done
@@ -0,0 +1,44 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="string comparison"
+
+DIR_DATA="data"
+DIR_STRINGS="${DIR_DATA}/strings"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/string_comparison.csv"
+
+BIN="build/bin/string_comparison"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="20000000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+FLAGS="--rmi --art --tlx --bin"
+
+run() {
+    DATA_FILE=$1
+    ${BIN} ${PARAMS} ${FLAGS} ${DATA_FILE} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check string datasets provided
+if [ ! -d "${DIR_STRINGS}" ];
+then
+    >&2 echo "Please place string datasets with one key per line in '${DIR_STRINGS}' first."
+    return 1
+fi
+
+# Run experiments
+echo "dataset,n_keys,index,config,size_in_bytes,rep,n_samples,build_time,eval_time,lookup_time,eval_accu,lookup_accu" > ${FILE_RESULTS} # Write csv header
+for file in ${DIR_STRINGS}/*;
+do
+    echo "Performing ${EXPERIMENT} on '$(basename ${file})'..."
+    run ${file}
+done